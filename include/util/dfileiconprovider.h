@@ -9,6 +9,9 @@
 #include <dtkwidget_global.h>
 
 #include <QFileIconProvider>
+#include <QMimeDatabase>
+
+#include <functional>
 
 DWIDGET_BEGIN_NAMESPACE
 
@@ -24,6 +27,12 @@ public:
     QIcon icon(const QFileInfo &info) const Q_DECL_OVERRIDE;
     QIcon icon(const QFileInfo &info, const QIcon &feedback) const;
 
+    void setMatchMode(QMimeDatabase::MatchMode mode);
+    QMimeDatabase::MatchMode matchMode() const;
+
+    void requestIcon(const QFileInfo &info, QObject *context, std::function<void(const QIcon &)> callback) const;
+    void clearCache();
+
 private:
     D_DECLARE_PRIVATE(DFileIconProvider)
     Q_DISABLE_COPY(DFileIconProvider)
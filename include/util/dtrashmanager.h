@@ -10,6 +10,7 @@
 #include <dtkwidget_global.h>
 
 #include <QObject>
+#include <QStringList>
 
 #if DTK_VERSION < DTK_VERSION_CHECK(6, 0, 0, 0)
 
@@ -18,6 +19,8 @@ DWIDGET_BEGIN_NAMESPACE
 class DTrashManagerPrivate;
 class D_DECL_DEPRECATED_X("Use libdtkcore") DTrashManager : public QObject, public DTK_CORE_NAMESPACE::DObject
 {
+    Q_OBJECT
+
 public:
     static DTrashManager *instance();
 
@@ -25,8 +28,21 @@ public:
     bool cleanTrash();
     bool moveToTrash(const QString &filePath, bool followSymlink = false);
 
+    bool moveToTrash(const QStringList &filePaths, bool followSymlink = false);
+    bool cleanTrashAsync();
+    bool isRunning() const;
+
+public Q_SLOTS:
+    void cancel();
+
+Q_SIGNALS:
+    void progressChanged(int done, int total);
+    void itemFailed(const QString &filePath, const QString &errorString);
+    void finished(bool ok);
+
 protected:
     DTrashManager();
+    ~DTrashManager() override;
 
 private:
     D_DECLARE_PRIVATE(DTrashManager)
@@ -50,6 +50,7 @@ public:
     int count() const Q_DECL_OVERRIDE;
     QLayoutItem *itemAt(int index) const Q_DECL_OVERRIDE;
     QSize minimumSize() const Q_DECL_OVERRIDE;
+    void invalidate() Q_DECL_OVERRIDE;
     void setGeometry(const QRect &rect) Q_DECL_OVERRIDE;
     QSize sizeHint() const Q_DECL_OVERRIDE;
     QLayoutItem *takeAt(int index) Q_DECL_OVERRIDE;
@@ -43,6 +43,9 @@ public:
     inline qreal opacity() const { return m_opacity; }
     inline void setOpacity(qreal opacity) { m_opacity = opacity; }
 
+protected:
+    void sourceChanged(ChangeFlags flags) override;
+
 private:
     qreal m_opacity = 1.0;
     qreal m_xOffset;
@@ -27,6 +27,8 @@ public:
     void setResetVisible(bool visible);
     void scrollToGroup(const QString &groupKey); //需要在对话框 show 以后使用
     void setIcon(const QIcon &icon);
+    void setLazyLoadEnabled(bool enabled);
+    bool lazyLoadEnabled() const;
 
 public Q_SLOTS:
     void updateSettings(DTK_CORE_NAMESPACE::DSettings *settings);
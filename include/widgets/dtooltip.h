@@ -29,6 +29,7 @@ public:
     static void setToolTipShowMode(QWidget *widget, ToolTipShowMode mode);
     static ToolTipShowMode toolTipShowMode(const QWidget *widget);
     static QString wrapToolTipText(QString text, QTextOption option);
+    static void setWrappedToolTip(QWidget *widget, const QString &text, const QTextOption &option);
     static bool needUpdateToolTip(const QWidget *widget, bool showToolTip);
     static void setShowToolTip(QWidget *widget, bool showToolTip);
 
@@ -4,54 +4,56 @@
 
 
 #include "daccessibilitychecker.h"
-
-#include <DObjectPrivate>
+#include "private/daccessibilitychecker_p.h"
 
 #include <QDebug>
 #include <QStandardItemModel>
-#include <QAbstractItemView>
 #include <QAccessible>
 #include <QAccessibleTableCellInterface>
 #include <QApplication>
 #include <QTimer>
+#include <QTreeView>
 
 DWIDGET_BEGIN_NAMESPACE
 
-class DAccessibilityCheckerPrivate : public DCORE_NAMESPACE::DObjectPrivate
+// 增量检查时每次处理的时间上限
+static const int IncrementalCheckBudget = 10;
+
+/*! \internal 向行区间列表中插入 count 行，之后的区间后移 */
+static void insertRows(QVector<QPair<int, int>> &ranges, int first, int count)
 {
-    D_DECLARE_PUBLIC(DAccessibilityChecker)
-public:
-    DAccessibilityCheckerPrivate(DAccessibilityChecker *qq);
-    bool check();
+    QVector<QPair<int, int>> result;
 
-    void checkWidgetName();
-    void checkViewItemName();
-    bool isIgnore(DAccessibilityChecker::Role role, const QWidget *w);
+    for (const auto &range : qAsConst(ranges)) {
+        if (range.second < first) {
+            result.append(range);
+        } else if (range.first >= first) {
+            result.append(qMakePair(range.first + count, range.second == INT_MAX ? INT_MAX : range.second + count));
+        } else {
+            result.append(qMakePair(range.first, first - 1));
+            result.append(qMakePair(first + count, range.second == INT_MAX ? INT_MAX : range.second + count));
+        }
+    }
 
-private:
-    bool checkViewItemNameFromAccessibleInteface(QAbstractItemView *listview);
-    bool checkViewItemNameFromAccessibleText(QAbstractItemView *listview);
+    ranges = result;
+}
 
-    bool isDefaultIgnoreWidget(const QWidget *w) const;
-    bool isDefaultIgnoreView(const QAbstractItemView *view) const;
+/*! \internal 从行区间列表中删除 [first, last]，之后的区间前移 */
+static void removeRows(QVector<QPair<int, int>> &ranges, int first, int last)
+{
+    const int count = last - first + 1;
+    QVector<QPair<int, int>> result;
 
-    QString widgetOutputLog(const QWidget *w) const;
-    QString widgetInfoString(const QWidget *w) const;
-    QString viewItemOutputLog(int rowIndex, int columnIndex, const QAbstractItemView *absView, const QString &itemText = QString()) const;
+    for (const auto &range : qAsConst(ranges)) {
+        if (range.first < first)
+            result.append(qMakePair(range.first, qMin(range.second, first - 1)));
 
-    void formatCheckResult();
-    void printSummaryResults();
-    void printRoleWarningOutput(const QString &roleString, const QStringList &roleList);
-    void _q_checkTimeout();
+        if (range.second > last)
+            result.append(qMakePair(qMax(range.first, last + 1) - count, range.second == INT_MAX ? INT_MAX : range.second - count));
+    }
 
-private:
-    QWidgetList topLevelWidgets;
-    QStringList widgetsWarningList;
-    QStringList itemWariningList;
-    DAccessibilityChecker::OutputFormat outputFormat;
-    QTimer *checkTimer;
-    int widgetIgnoredCount;
-};
+    ranges = result;
+}
 
 /*! \internal */
 DAccessibilityCheckerPrivate::DAccessibilityCheckerPrivate(DAccessibilityChecker *qq)
@@ -61,7 +63,10 @@ DAccessibilityCheckerPrivate::DAccessibilityCheckerPrivate(DAccessibilityChecker
     , itemWariningList()
     , outputFormat(DAccessibilityChecker::AssertFormat)
     , checkTimer(nullptr)
+    , widgetCount(0)
     , widgetIgnoredCount(0)
+    , eventFilter(nullptr)
+    , continuationScheduled(false)
 {
 }
 
@@ -73,6 +78,10 @@ bool DAccessibilityCheckerPrivate::check()
         return true;
     }
 
+    widgetsWarningList.clear();
+    itemWariningList.clear();
+    widgetIgnoredCount = 0;
+
     checkWidgetName();
     checkViewItemName();
 
@@ -86,38 +95,48 @@ bool DAccessibilityCheckerPrivate::check()
     return false;
 }
 
-/*! \internal */
-void DAccessibilityCheckerPrivate::checkWidgetName()
+/*!
+   \internal
+   \brief 检查单个控件的自动化标记名称，全日志模式下由调用者记录失败信息.
+ */
+DAccessibilityCheckerPrivate::WidgetStatus DAccessibilityCheckerPrivate::checkWidget(QWidget *w)
 {
     D_Q(DAccessibilityChecker);
 
+    if (q->isIgnore(DAccessibilityChecker::Widget, w))
+        return Ignored;
+
+    const QAccessibleInterface *interface = QAccessible::queryAccessibleInterface(w);
+    bool hasNoText;
+    if (interface && interface->isValid()) {
+        hasNoText = interface->text(QAccessible::Name).isEmpty();
+    } else {
+        hasNoText = w->accessibleName().isEmpty();
+    }
+
+    if (outputFormat == DAccessibilityChecker::AssertFormat)
+        Q_ASSERT_X(!hasNoText, "Widget Accessible Name Check", widgetOutputLog(w).toLocal8Bit());
+
+    return hasNoText ? Failed : Passed;
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::checkWidgetName()
+{
     QWidgetList childrenList(topLevelWidgets);
     for (const QWidget *topLevelWidget : topLevelWidgets)
         childrenList.append(topLevelWidget->findChildren<QWidget *>());
 
+    widgetCount = childrenList.count();
+
     for (auto child : qAsConst(childrenList)) {
-        if (q->isIgnore(DAccessibilityChecker::Widget, child)) {
+        switch (checkWidget(child)) {
+        case Ignored:
             widgetIgnoredCount++;
-            continue;
-        }
-
-        const QAccessibleInterface *interface = QAccessible::queryAccessibleInterface(child);
-        bool hasNoText;
-        if (interface && interface->isValid()) {
-            hasNoText = interface->text(QAccessible::Name).isEmpty();
-        } else {
-            hasNoText = child->accessibleName().isEmpty();
-        }
-
-        switch (outputFormat) {
-        case DAccessibilityChecker::AssertFormat: {
-            Q_ASSERT_X(hasNoText, "Widget Accessible Name Check", widgetOutputLog(child).toLocal8Bit());
-        }
             break;
-        case DAccessibilityChecker::FullFormat: {
-            if (hasNoText)
+        case Failed:
+            if (outputFormat == DAccessibilityChecker::FullFormat)
                 widgetsWarningList.append(widgetOutputLog(child));
-        }
             break;
         default:
             break;
@@ -138,11 +157,42 @@ void DAccessibilityCheckerPrivate::checkViewItemName()
         if (q->isIgnore(DAccessibilityChecker::ViewItem, absListView))
             continue;
 
-        if (!checkViewItemNameFromAccessibleInteface(absListView))
-            checkViewItemNameFromAccessibleText(absListView);
+        checkViewItems(absListView, 0, INT_MAX, &itemWariningList);
     }
 }
 
+/*!
+   \internal
+   \brief 检查视图中 [firstRow, lastRow] 行的项.
+
+   \return 视图既没有 table interface 也不是 QStandardItemModel 时返回 -1，否则返回缺失名称的项数。
+ */
+int DAccessibilityCheckerPrivate::checkViewItems(QAbstractItemView *view, int firstRow, int lastRow, QStringList *warnings)
+{
+    int failedCount = 0;
+
+    if (checkViewItemNameFromAccessibleInteface(view, firstRow, lastRow, &failedCount, warnings))
+        return failedCount;
+
+    if (checkViewItemNameFromAccessibleText(view, firstRow, lastRow, &failedCount, warnings))
+        return failedCount;
+
+    return -1;
+}
+
+/*! \internal */
+int DAccessibilityCheckerPrivate::viewRowCount(QAbstractItemView *view) const
+{
+    auto tableAbsInterface = QAccessible::queryAccessibleInterface(view);
+    if (tableAbsInterface && tableAbsInterface->isValid() && tableAbsInterface->tableInterface())
+        return tableAbsInterface->tableInterface()->rowCount();
+
+    if (QStandardItemModel *model = qobject_cast<QStandardItemModel *>(view->model()))
+        return model->rowCount();
+
+    return -1;
+}
+
 /*! \internal */
 bool DAccessibilityCheckerPrivate::isIgnore(DAccessibilityChecker::Role role, const QWidget *w)
 {
@@ -178,7 +228,7 @@ bool DAccessibilityCheckerPrivate::isDefaultIgnoreView(const QAbstractItemView *
 
    \return 成功返回true，失败返回false。
  */
-bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleInteface(QAbstractItemView *listview)
+bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleInteface(QAbstractItemView *listview, int firstRow, int lastRow, int *failedCount, QStringList *warnings)
 {
     auto tableAbsInterface = QAccessible::queryAccessibleInterface(listview);
     bool ret = false;
@@ -191,18 +241,23 @@ bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleInteface(QAbst
         return ret;
 
     ret = true;
-    for (int rowIdx = 0; rowIdx < tableInterface->rowCount(); ++rowIdx) {
+    const int rowCount = qMin(tableInterface->rowCount(), lastRow == INT_MAX ? INT_MAX : lastRow + 1);
+    for (int rowIdx = firstRow; rowIdx < rowCount; ++rowIdx) {
         for (int columnIdx = 0; columnIdx < tableInterface->columnCount(); ++columnIdx) {
             QAccessibleInterface *cellAbsInterface = tableInterface->cellAt(rowIdx, columnIdx);
             if (cellAbsInterface && cellAbsInterface->isValid()) {
+                const bool hasNoText = cellAbsInterface->text(QAccessible::Name).isEmpty();
+                if (hasNoText)
+                    ++*failedCount;
+
                 switch (outputFormat) {
                 case DAccessibilityChecker::AssertFormat: {
-                    Q_ASSERT_X(!cellAbsInterface->text(QAccessible::Name).isEmpty(), "Item Accessible Text Check", viewItemOutputLog(rowIdx, columnIdx, listview).toLocal8Bit());
+                    Q_ASSERT_X(!hasNoText, "Item Accessible Text Check", viewItemOutputLog(rowIdx, columnIdx, listview).toLocal8Bit());
                 }
                     break;
                 case DAccessibilityChecker::FullFormat: {
-                    if (cellAbsInterface->text(QAccessible::Name).isEmpty()) {
-                        itemWariningList.append(viewItemOutputLog(rowIdx, columnIdx, listview));
+                    if (hasNoText) {
+                        warnings->append(viewItemOutputLog(rowIdx, columnIdx, listview));
                     }
                 }
                     break;
@@ -222,7 +277,7 @@ bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleInteface(QAbst
 
    \return 成功返回true，失败返回false。
  */
-bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleText(QAbstractItemView *listview)
+bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleText(QAbstractItemView *listview, int firstRow, int lastRow, int *failedCount, QStringList *warnings)
 {
     QStandardItemModel *model = qobject_cast<QStandardItemModel *>(listview->model());
     bool ret = false;
@@ -231,21 +286,26 @@ bool DAccessibilityCheckerPrivate::checkViewItemNameFromAccessibleText(QAbstract
         return ret;
 
     ret = true;
-    for (int rowIdx = 0; rowIdx < model->rowCount(); ++rowIdx) {
+    const int rowCount = qMin(model->rowCount(), lastRow == INT_MAX ? INT_MAX : lastRow + 1);
+    for (int rowIdx = firstRow; rowIdx < rowCount; ++rowIdx) {
         for (int columnIdx = 0; columnIdx < model->columnCount(); ++columnIdx) {
             auto standardItem = model->item(rowIdx, columnIdx);
 
             if (!standardItem)
                 continue;
 
+            const bool hasNoText = standardItem->accessibleText().isEmpty();
+            if (hasNoText)
+                ++*failedCount;
+
             switch (outputFormat) {
             case DAccessibilityChecker::AssertFormat: {
-                Q_ASSERT_X(!standardItem->accessibleText().isEmpty(), "Item Accessible Text Check", QStringLiteral("\n%1\n").arg(viewItemOutputLog(rowIdx, columnIdx, listview, standardItem->text())).toLocal8Bit());
+                Q_ASSERT_X(!hasNoText, "Item Accessible Text Check", QStringLiteral("\n%1\n").arg(viewItemOutputLog(rowIdx, columnIdx, listview, standardItem->text())).toLocal8Bit());
             }
                 break;
             case DAccessibilityChecker::FullFormat: {
-                if (standardItem->accessibleText().isEmpty())
-                    itemWariningList.append(viewItemOutputLog(rowIdx, columnIdx, listview, standardItem->text()));
+                if (hasNoText)
+                    warnings->append(viewItemOutputLog(rowIdx, columnIdx, listview, standardItem->text()));
             }
                 break;
             default:
@@ -349,7 +409,7 @@ void DAccessibilityCheckerPrivate::formatCheckResult()
  */
 void DAccessibilityCheckerPrivate::printSummaryResults()
 {
-    int totalWidgetsCount = std::accumulate(this->topLevelWidgets.begin(), this->topLevelWidgets.end(), 0, [](int before, const QWidget *after) -> int { return before + after->findChildren<QWidget *>().count(); }) + this->topLevelWidgets.count();
+    const int totalWidgetsCount = this->widgetCount;
 
     QString summary("[=============]Result Summary: Total Widgets Number: %1    Succeeded: %2    Failed: %3    Ignored: %4");
     qWarning().noquote() << summary.arg(totalWidgetsCount).arg(totalWidgetsCount - this->widgetsWarningList.count() - this->widgetIgnoredCount).arg(this->widgetsWarningList.count()).arg(this->widgetIgnoredCount);
@@ -367,15 +427,428 @@ void DAccessibilityCheckerPrivate::printRoleWarningOutput(const QString &roleStr
 }
 
 void DAccessibilityCheckerPrivate::_q_checkTimeout()
+{
+    // 上一轮还没处理完时由它自己继续
+    if (continuationScheduled)
+        return;
+
+    syncTopLevelWidgets();
+
+    // 失败的控件可能在之后补上了名称，每轮重新检查
+    for (const WidgetState &state : qAsConst(widgetStates)) {
+        if (state.status == Failed && state.widget)
+            pendingWidgets.append(state.widget);
+    }
+
+    for (auto it = views.begin(); it != views.end(); ++it) {
+        ViewState &state = it.value();
+
+        if (state.view && state.model != state.view->model())
+            watchModel(state);
+
+        for (int row : qAsConst(state.failedRows))
+            state.dirtyRows.append(qMakePair(row, row));
+    }
+
+    checkIncrementally();
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::widgetAdded(QWidget *w)
+{
+    // 此时控件可能还未构造完成，留到下次检查时处理
+    pendingWidgets.append(w);
+}
+
+/*!
+   \internal
+   \brief 控件移出父控件时移除整棵子树的状态.
+
+   只有子树的根节点会收到 ChildRemoved；若控件被移到别处，之后的 ChildAdded 会重新检查它。
+ */
+void DAccessibilityCheckerPrivate::widgetRemoved(QObject *object)
+{
+    forgetWidget(object);
+
+    for (QWidget *child : object->findChildren<QWidget *>())
+        forgetWidget(child);
+}
+
+/*!
+   \internal
+   \brief 随父控件一起析构的子控件不会收到 ChildRemoved，通过 destroyed 移除.
+ */
+void DAccessibilityCheckerPrivate::widgetDestroyed(QObject *object)
+{
+    forgetWidget(object);
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::ensureEventFilter()
+{
+    D_Q(DAccessibilityChecker);
+
+    if (eventFilter)
+        return;
+
+    eventFilter = new DAccessibilityCheckerEventFilter(this, q);
+    qApp->installEventFilter(eventFilter);
+}
+
+/*!
+   \internal
+   \brief 在时间预算内处理待检查的控件和视图行，处理完后输出与全量检查相同的结果.
+ */
+void DAccessibilityCheckerPrivate::checkIncrementally()
 {
     D_Q(DAccessibilityChecker);
-    this->topLevelWidgets = qApp->topLevelWidgets();
-    this->widgetIgnoredCount = 0;
 
-    if (!q->check())
+    continuationScheduled = false;
+
+    bool checked = false;
+    if (!processIncrementalChecks(&checked)) {
+        continuationScheduled = true;
+        QTimer::singleShot(0, q, [this] { checkIncrementally(); });
+        return;
+    }
+
+    if (!checked)
+        return;
+
+    collectIncrementalResult();
+
+    if (outputFormat == DAccessibilityChecker::FullFormat)
+        formatCheckResult();
+
+    printSummaryResults();
+
+    if (!widgetsWarningList.isEmpty() || !itemWariningList.isEmpty())
         abort();
 }
 
+/*!
+   \internal
+   \brief 在一次时间预算内检查待处理的控件和视图行.
+
+   \a checked 在检查过任何内容时置为 true。
+   \return 没有待处理的内容时返回 true。
+ */
+bool DAccessibilityCheckerPrivate::processIncrementalChecks(bool *checked)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!pendingWidgets.isEmpty() && !timer.hasExpired(IncrementalCheckBudget)) {
+        const QPointer<QWidget> w = pendingWidgets.takeFirst();
+
+        if (w) {
+            checkWidgetIncrementally(w);
+            *checked = true;
+        }
+    }
+
+    if (checkDirtyViewRows(timer))
+        *checked = true;
+
+    if (!pendingWidgets.isEmpty())
+        return false;
+
+    for (auto it = views.cbegin(); it != views.cend(); ++it) {
+        if (!it->dirtyRows.isEmpty())
+            return false;
+    }
+
+    return true;
+}
+
+/*! \internal 新出现的顶层窗口连同其所有子控件加入检查 */
+void DAccessibilityCheckerPrivate::syncTopLevelWidgets()
+{
+    QSet<QObject *> currentTopLevelWidgets;
+
+    for (QWidget *w : qApp->topLevelWidgets()) {
+        currentTopLevelWidgets.insert(w);
+
+        if (knownTopLevelWidgets.contains(w))
+            continue;
+
+        pendingWidgets.append(w);
+    }
+
+    knownTopLevelWidgets = currentTopLevelWidgets;
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::checkWidgetIncrementally(QWidget *w)
+{
+    D_Q(DAccessibilityChecker);
+
+    if (!isTracked(w)) {
+        QObject::connect(w, &QObject::destroyed, eventFilter,
+                         &DAccessibilityCheckerEventFilter::widgetDestroyed, Qt::UniqueConnection);
+    }
+
+    setWidgetStatus(w, checkWidget(w));
+
+    // 整棵子树被移入时只会收到根节点的 ChildAdded
+    for (QObject *child : w->children()) {
+        if (child->isWidgetType() && !isTracked(child))
+            pendingWidgets.append(static_cast<QWidget *>(child));
+    }
+
+    if (QAbstractItemView *view = qobject_cast<QAbstractItemView *>(w)) {
+        if (!isWatchedView(view) && !q->isIgnore(DAccessibilityChecker::ViewItem, view))
+            watchView(view);
+    }
+}
+
+/*! \internal */
+bool DAccessibilityCheckerPrivate::isTracked(const QObject *object) const
+{
+    auto it = widgetStates.constFind(const_cast<QObject *>(object));
+    return it != widgetStates.constEnd() && it->widget == object;
+}
+
+/*! \internal */
+bool DAccessibilityCheckerPrivate::isWatchedView(const QObject *view) const
+{
+    auto it = views.constFind(const_cast<QObject *>(view));
+    return it != views.constEnd() && it->view == view;
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::setWidgetStatus(QWidget *w, WidgetStatus status)
+{
+    WidgetState &state = widgetStates[w];
+    state.widget = w;
+    state.status = status;
+}
+
+/*! \internal 移除控件的检查状态，若是视图则断开对其 model 的监听 */
+void DAccessibilityCheckerPrivate::forgetWidget(QObject *object)
+{
+    widgetStates.remove(object);
+    knownTopLevelWidgets.remove(object);
+
+    auto it = views.find(object);
+    if (it != views.end()) {
+        for (const QMetaObject::Connection &connection : qAsConst(it->connections))
+            QObject::disconnect(connection);
+
+        views.erase(it);
+    }
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::watchView(QAbstractItemView *view)
+{
+    ViewState &state = views[view];
+    state.view = view;
+
+    if (QTreeView *treeView = qobject_cast<QTreeView *>(view)) {
+        // 树的 accessible 行号随展开状态变化
+        QObject::connect(treeView, &QTreeView::expanded, eventFilter, [this, view] { resetView(view); });
+        QObject::connect(treeView, &QTreeView::collapsed, eventFilter, [this, view] { resetView(view); });
+    }
+
+    watchModel(state);
+}
+
+/*! \internal 重新连接视图当前 model 的信号并全量检查该视图 */
+void DAccessibilityCheckerPrivate::watchModel(ViewState &state)
+{
+    for (const QMetaObject::Connection &connection : qAsConst(state.connections))
+        QObject::disconnect(connection);
+
+    state.connections.clear();
+
+    QAbstractItemView *view = state.view;
+    QAbstractItemModel *model = view->model();
+    state.model = model;
+
+    resetView(view);
+
+    if (!model)
+        return;
+
+    auto reset = [this, view] { resetView(view); };
+
+    state.connections << QObject::connect(model, &QAbstractItemModel::rowsInserted, view, [this, view] (const QModelIndex &parent, int first, int last) {
+        insertViewRows(view, parent, first, last);
+    });
+    state.connections << QObject::connect(model, &QAbstractItemModel::rowsRemoved, view, [this, view] (const QModelIndex &parent, int first, int last) {
+        removeViewRows(view, parent, first, last);
+    });
+    state.connections << QObject::connect(model, &QAbstractItemModel::dataChanged, view, [this, view] (const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        markViewRowsDirty(view, topLeft.parent(), topLeft.row(), bottomRight.row());
+    });
+    state.connections << QObject::connect(model, &QAbstractItemModel::modelReset, view, reset);
+    state.connections << QObject::connect(model, &QAbstractItemModel::layoutChanged, view, reset);
+    state.connections << QObject::connect(model, &QAbstractItemModel::rowsMoved, view, reset);
+    state.connections << QObject::connect(model, &QAbstractItemModel::columnsInserted, view, reset);
+    state.connections << QObject::connect(model, &QAbstractItemModel::columnsRemoved, view, reset);
+    state.connections << QObject::connect(model, &QAbstractItemModel::columnsMoved, view, reset);
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::resetView(QObject *view)
+{
+    auto it = views.find(view);
+    if (it == views.end())
+        return;
+
+    it->failedRows.clear();
+    it->dirtyRows = { qMakePair(0, INT_MAX) };
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::insertViewRows(QObject *view, const QModelIndex &parent, int first, int last)
+{
+    // 只检查顶层行，子节点的变化只影响树的行号
+    if (parent.isValid()) {
+        if (qobject_cast<QTreeView *>(view))
+            resetView(view);
+
+        return;
+    }
+
+    auto it = views.find(view);
+    if (it == views.end())
+        return;
+
+    const int count = last - first + 1;
+    QSet<int> failedRows;
+    for (int row : qAsConst(it->failedRows))
+        failedRows.insert(row >= first ? row + count : row);
+
+    it->failedRows = failedRows;
+    insertRows(it->dirtyRows, first, count);
+    it->dirtyRows.append(qMakePair(first, last));
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::removeViewRows(QObject *view, const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        if (qobject_cast<QTreeView *>(view))
+            resetView(view);
+
+        return;
+    }
+
+    auto it = views.find(view);
+    if (it == views.end())
+        return;
+
+    const int count = last - first + 1;
+    QSet<int> failedRows;
+    for (int row : qAsConst(it->failedRows)) {
+        if (row < first) {
+            failedRows.insert(row);
+        } else if (row > last) {
+            failedRows.insert(row - count);
+        }
+    }
+
+    it->failedRows = failedRows;
+    removeRows(it->dirtyRows, first, last);
+}
+
+/*! \internal */
+void DAccessibilityCheckerPrivate::markViewRowsDirty(QObject *view, const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        if (qobject_cast<QTreeView *>(view))
+            resetView(view);
+
+        return;
+    }
+
+    auto it = views.find(view);
+    if (it != views.end())
+        it->dirtyRows.append(qMakePair(first, last));
+}
+
+/*!
+   \internal
+   \brief 在时间预算内逐行检查各视图中变化过的行.
+
+   \return 检查过任何一行时返回 true。
+ */
+bool DAccessibilityCheckerPrivate::checkDirtyViewRows(const QElapsedTimer &timer)
+{
+    bool checked = false;
+
+    for (auto it = views.begin(); it != views.end(); ++it) {
+        QAbstractItemView *view = it->view;
+
+        if (!view) {
+            it->dirtyRows.clear();
+            continue;
+        }
+
+        const int rowCount = viewRowCount(view);
+
+        while (!it->dirtyRows.isEmpty()) {
+            if (timer.hasExpired(IncrementalCheckBudget))
+                return checked;
+
+            QPair<int, int> &range = it->dirtyRows.last();
+            const int row = range.first;
+
+            if (row > range.second || row >= rowCount) {
+                it->dirtyRows.removeLast();
+                continue;
+            }
+
+            ++range.first;
+            checked = true;
+
+            QStringList warnings;
+            if (checkViewItems(view, row, row, &warnings) > 0) {
+                it->failedRows.insert(row);
+            } else {
+                it->failedRows.remove(row);
+            }
+        }
+    }
+
+    return checked;
+}
+
+/*! \internal 根据增量检查的状态生成与全量检查相同的结果 */
+void DAccessibilityCheckerPrivate::collectIncrementalResult()
+{
+    widgetCount = widgetStates.count();
+    widgetIgnoredCount = 0;
+    widgetsWarningList.clear();
+    itemWariningList.clear();
+
+    for (const WidgetState &state : qAsConst(widgetStates)) {
+        if (state.status == Ignored)
+            ++widgetIgnoredCount;
+    }
+
+    if (outputFormat != DAccessibilityChecker::FullFormat)
+        return;
+
+    for (const WidgetState &state : qAsConst(widgetStates)) {
+        if (state.status == Failed && state.widget)
+            widgetsWarningList.append(widgetOutputLog(state.widget));
+    }
+
+    for (auto it = views.cbegin(); it != views.cend(); ++it) {
+        if (!it->view)
+            continue;
+
+        QList<int> failedRows = it->failedRows.values();
+        std::sort(failedRows.begin(), failedRows.end());
+
+        for (int row : qAsConst(failedRows))
+            checkViewItems(it->view, row, row, &itemWariningList);
+    }
+}
+
 /*!
   \class Dtk::Widget::DAccessibilityChecker
   \inmodule dtkwidget
@@ -385,8 +858,8 @@ void DAccessibilityCheckerPrivate::_q_checkTimeout()
   这是一个用于检测控件自动化标记是否完整添加的类，推荐该类在Debug模式下工作。可以使
   用 QT_DEBUG 或 QT_NO_DEBUG 宏指定当前是否为debug模式。断言输出模式下，程序在遇到控
   件不存在自动化标记名称时断言退出，并提示出具体控件和路径；全输出模式下，程序会输出
-  全部的日志信息，且程序不会退出。除此之外，start() 函数会每隔3秒执行 check() 函数，
-  如发现有控件不存在自动化标记名称，程序会直接退出并提示对应控件信息。一般的使用方法
+  全部的日志信息，且程序不会退出。除此之外，start() 函数会每隔3秒增量地检查新增和变化
+  过的控件及视图项，如发现有控件不存在自动化标记名称，程序会直接退出并提示对应控件信息。一般的使用方法
   如下代码所示：
   \code
   MainWindow w;
@@ -495,6 +968,8 @@ bool DAccessibilityChecker::check()
   \brief 定时检测控件的标记名称.
 
   调用此函数会定时执行自动化标记检测，如果发现某控件的自动化标记存在缺失，则程序退出并提示出控件的相关信息。
+  首次检查全部控件，之后只检查新增的控件和 model 中变化的行，每次检查的耗时有上限，
+  未处理完的部分在事件循环空闲时继续，结果与 check() 一致。
   \a msec 定时开启的时间，默认为3秒.
 
   \sa check()
@@ -508,6 +983,8 @@ void DAccessibilityChecker::start(int msec)
         QObject::connect(d->checkTimer,  SIGNAL(timeout()), this, SLOT(_q_checkTimeout()));
     }
 
+    d->ensureEventFilter();
+
     // 先立即执行 再开始定时器执行。
     d->_q_checkTimeout();
     d->checkTimer->start(msec);
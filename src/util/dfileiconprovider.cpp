@@ -7,10 +7,15 @@
 #include <DIconTheme>
 
 #include "dfileiconprovider.h"
+#include "private/dfileiconprovider_p.h"
 
+#include <QCoreApplication>
+#include <QDateTime>
 #include <QLibrary>
-#include <QMimeDatabase>
 #include <QMimeType>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QtConcurrent>
 #include <QDebug>
 
 #ifdef USE_GTK_PLUS_2_0
@@ -55,7 +60,12 @@ public:
 
     void init();
     QIcon getFilesystemIcon(const QFileInfo &info) const;
-    QIcon fromTheme(QString iconName) const;
+    static bool hasGtkLookup();
+    static QIcon gtkFilesystemIcon(DFileIconCache *cache, const QFileInfo &info);
+    static QIcon fromTheme(QString iconName);
+
+    QSharedPointer<DFileIconCache> cache;
+    QMimeDatabase::MatchMode matchMode = QMimeDatabase::MatchDefault;
 
     D_DECLARE_PUBLIC(DFileIconProvider)
 
@@ -74,8 +84,99 @@ Ptr_gtk_icon_theme_get_default DFileIconProviderPrivate::gtk_icon_theme_get_defa
 };
 #endif
 
+QString DFileIconCache::fileKey(const QFileInfo &info, QMimeDatabase::MatchMode mode)
+{
+    if (info.isDir())
+        return QStringLiteral("d");
+
+    // 只按文件名匹配时结果只取决于文件名，glob 规则还会匹配完整文件名和前缀
+    // （如 CMakeLists.txt、README*、*.tar.gz），因此不能按后缀共享
+    if (mode == QMimeDatabase::MatchExtension)
+        return QStringLiteral("n:") + info.fileName();
+
+    return QStringLiteral("f:%1:%2:%3").arg(info.absoluteFilePath(),
+                                            QString::number(info.lastModified().toMSecsSinceEpoch()),
+                                            QString::number(info.size()));
+}
+
+QString DFileIconCache::mimeTypeName(const QFileInfo &info, QMimeDatabase::MatchMode mode)
+{
+    const QString &key = fileKey(info, mode);
+
+    {
+        QMutexLocker locker(&mutex);
+        if (const QString *name = mimeTypeNames.object(key))
+            return *name;
+    }
+
+    // 可能读取文件内容，不持有锁
+    const QString &name = mimeDatabase.mimeTypeForFile(info, mode).name();
+
+    QMutexLocker locker(&mutex);
+    mimeTypeNames.insert(key, new QString(name));
+
+    return name;
+}
+
+QIcon DFileIconCache::mimeTypeIcon(const QString &mimeTypeName)
+{
+    const QString &key = QStringLiteral("m:") + mimeTypeName;
+
+    {
+        QMutexLocker locker(&mutex);
+        checkIconTheme();
+        if (const QIcon *icon = icons.object(key))
+            return *icon;
+    }
+
+    const QMimeType &type = mimeDatabase.mimeTypeForName(mimeTypeName);
+    QIcon icon = DFileIconProviderPrivate::fromTheme(type.iconName());
+
+    if (icon.isNull()) {
+        icon = DFileIconProviderPrivate::fromTheme(type.genericIconName());
+    }
+
+    insertIcon(key, icon);
+
+    return icon;
+}
+
+QIcon DFileIconCache::icon(const QString &key)
+{
+    QMutexLocker locker(&mutex);
+    checkIconTheme();
+    const QIcon *icon = icons.object(key);
+
+    return icon ? *icon : QIcon();
+}
+
+void DFileIconCache::insertIcon(const QString &key, const QIcon &icon)
+{
+    QMutexLocker locker(&mutex);
+    icons.insert(key, new QIcon(icon));
+}
+
+void DFileIconCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    mimeTypeNames.clear();
+    icons.clear();
+}
+
+void DFileIconCache::checkIconTheme()
+{
+    // 图标主题切换后缓存的图标全部失效
+    const QString &themeName = QIcon::themeName();
+
+    if (themeName != iconThemeName) {
+        icons.clear();
+        iconThemeName = themeName;
+    }
+}
+
 DFileIconProviderPrivate::DFileIconProviderPrivate(DFileIconProvider *qq)
     : DObjectPrivate(qq)
+    , cache(new DFileIconCache)
 {
     init();
 }
@@ -92,38 +193,59 @@ void DFileIconProviderPrivate::init()
 }
 
 QIcon DFileIconProviderPrivate::getFilesystemIcon(const QFileInfo &info) const
+{
+    if (hasGtkLookup())
+        return gtkFilesystemIcon(cache.data(), info);
+
+    return cache->mimeTypeIcon(cache->mimeTypeName(info, matchMode));
+}
+
+bool DFileIconProviderPrivate::hasGtkLookup()
 {
 #ifdef USE_GTK_PLUS_2_0
-    if (gnome_vfs_init && gnome_icon_lookup_sync && gtk_icon_theme_get_default) {
-        gnome_vfs_init();
-        GtkIconTheme *theme = gtk_icon_theme_get_default();
-        QByteArray fileurl = QUrl::fromLocalFile(info.absoluteFilePath()).toEncoded();
-        char *icon_name = gnome_icon_lookup_sync(theme,
-                          NULL,
-                          fileurl.data(),
-                          NULL,
-                          GNOME_ICON_LOOKUP_FLAGS_NONE,
-                          NULL);
-        QString iconName = QString::fromUtf8(icon_name);
-        g_free(icon_name);
-        if (iconName.startsWith(QLatin1Char('/'))) {
-            return QIcon(iconName);
-        }
-        return fromTheme(iconName);
-    }
+    return gnome_vfs_init && gnome_icon_lookup_sync && gtk_icon_theme_get_default;
+#else
+    return false;
 #endif
+}
 
-    const QMimeType &db = QMimeDatabase().mimeTypeForFile(info);
-    const QIcon &icon = fromTheme(db.iconName());
+// 只能在主线程中调用
+QIcon DFileIconProviderPrivate::gtkFilesystemIcon(DFileIconCache *cache, const QFileInfo &info)
+{
+#ifdef USE_GTK_PLUS_2_0
+    const QString &key = QStringLiteral("g:") + DFileIconCache::fileKey(info, QMimeDatabase::MatchDefault);
+    QIcon icon = cache->icon(key);
 
     if (!icon.isNull()) {
         return icon;
     }
 
-    return fromTheme(db.genericIconName());
+    gnome_vfs_init();
+    GtkIconTheme *theme = gtk_icon_theme_get_default();
+    QByteArray fileurl = QUrl::fromLocalFile(info.absoluteFilePath()).toEncoded();
+    char *icon_name = gnome_icon_lookup_sync(theme,
+                      NULL,
+                      fileurl.data(),
+                      NULL,
+                      GNOME_ICON_LOOKUP_FLAGS_NONE,
+                      NULL);
+    QString iconName = QString::fromUtf8(icon_name);
+    g_free(icon_name);
+    if (iconName.startsWith(QLatin1Char('/'))) {
+        icon = QIcon(iconName);
+    } else {
+        icon = fromTheme(iconName);
+    }
+    cache->insertIcon(key, icon);
+    return icon;
+#else
+    Q_UNUSED(cache)
+    Q_UNUSED(info)
+    return QIcon();
+#endif
 }
 
-QIcon DFileIconProviderPrivate::fromTheme(QString iconName) const
+QIcon DFileIconProviderPrivate::fromTheme(QString iconName)
 {
     QIcon icon = DIconTheme::findQIcon(iconName);
 
@@ -182,4 +304,70 @@ QIcon DFileIconProvider::icon(const QFileInfo &info, const QIcon &feedback) cons
     return icon;
 }
 
+/*!
+  \brief 设置识别文件 mime 类型的方式.
+
+  设置为 QMimeDatabase::MatchExtension 时只根据文件名判断，不会读取文件内容，
+  默认为 QMimeDatabase::MatchDefault。
+ */
+void DFileIconProvider::setMatchMode(QMimeDatabase::MatchMode mode)
+{
+    D_D(DFileIconProvider);
+
+    d->matchMode = mode;
+}
+
+QMimeDatabase::MatchMode DFileIconProvider::matchMode() const
+{
+    D_DC(DFileIconProvider);
+
+    return d->matchMode;
+}
+
+/*!
+  \brief 异步获取 \a info 的图标.
+
+  mime 类型在工作线程中识别，之后在主线程中查找图标并调用 \a callback，
+  若 \a context 已被销毁则不再调用。使用 GTK 查找图标时整个查找都在主线程中进行，
+  结果与 icon() 一致。
+ */
+void DFileIconProvider::requestIcon(const QFileInfo &info, QObject *context, std::function<void(const QIcon &)> callback) const
+{
+    D_DC(DFileIconProvider);
+
+    const QSharedPointer<DFileIconCache> cache = d->cache;
+    const QMimeDatabase::MatchMode mode = d->matchMode;
+    const QString filePath = info.absoluteFilePath();
+    const QPointer<QObject> receiver(context);
+
+    if (DFileIconProviderPrivate::hasGtkLookup()) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [cache, filePath, receiver, callback] {
+            if (receiver) {
+                callback(DFileIconProviderPrivate::gtkFilesystemIcon(cache.data(), QFileInfo(filePath)));
+            }
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    QtConcurrent::run([cache, mode, filePath, receiver, callback] {
+        const QString &name = cache->mimeTypeName(QFileInfo(filePath), mode);
+
+        if (!QCoreApplication::instance())
+            return;
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [cache, name, receiver, callback] {
+            if (receiver) {
+                callback(cache->mimeTypeIcon(name));
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DFileIconProvider::clearCache()
+{
+    D_D(DFileIconProvider);
+
+    d->cache->clear();
+}
+
 DWIDGET_END_NAMESPACE
@@ -10,10 +10,26 @@
 #include <DStandardPaths>
 
 #include <QDirIterator>
-#include <QStorageInfo>
 #include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include <functional>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef RENAME_NOREPLACE
+#define RENAME_NOREPLACE (1 << 0)
+#endif
 
 #define TRASH_PATH \
     DCORE_NAMESPACE::DStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/Trash"
@@ -50,9 +66,9 @@ static QString getNotExistsFileName(const QString &fileName, const QString &targ
     return QString::fromUtf8(name + suffix);
 }
 
-static bool writeTrashInfo(const QString &fileBaseName, const QString &sourceFilePath, const QDateTime &datetime, QString *errorString = NULL)
+static bool writeTrashInfo(const QString &infoPath, const QString &fileBaseName, const QString &sourceFilePath, const QDateTime &datetime, QString *errorString = NULL)
 {
-    QFile metadata(TRASH_INFO_PATH"/" + fileBaseName + ".trashinfo");
+    QFile metadata(infoPath + "/" + fileBaseName + ".trashinfo");
 
     if (metadata.exists()) {
         if (errorString) {
@@ -90,6 +106,30 @@ static bool writeTrashInfo(const QString &fileBaseName, const QString &sourceFil
     return true;
 }
 
+// 原子地重命名，目标已存在时失败而不是覆盖，失败时保留 errno
+static bool renameNoReplace(const QString &source, const QString &target)
+{
+    const QByteArray &from = QFile::encodeName(source);
+    const QByteArray &to = QFile::encodeName(target);
+
+#ifdef SYS_renameat2
+    if (syscall(SYS_renameat2, AT_FDCWD, from.constData(), AT_FDCWD, to.constData(), RENAME_NOREPLACE) == 0)
+        return true;
+
+    // 内核或文件系统不支持 renameat2/RENAME_NOREPLACE 时才退回到 rename
+    if (errno != ENOSYS && errno != EINVAL)
+        return false;
+#endif
+
+    struct stat st;
+    if (lstat(to.constData(), &st) == 0) {
+        errno = EEXIST;
+        return false;
+    }
+
+    return ::rename(from.constData(), to.constData()) == 0;
+}
+
 static bool renameFile(const QFileInfo &fileInfo, const QString &target, QString *errorString = NULL)
 {
     if (fileInfo.isFile() || fileInfo.isSymLink()) {
@@ -105,6 +145,19 @@ static bool renameFile(const QFileInfo &fileInfo, const QString &target, QString
 
         return true;
     } else {
+        // 回收站与源文件在同一文件系统上，整个目录只需一次重命名
+        if (renameNoReplace(fileInfo.filePath(), target))
+            return true;
+
+        // 只有跨设备（如 bind mount）时才逐个文件移动
+        if (errno != EXDEV) {
+            if (errorString) {
+                *errorString = QString::fromLocal8Bit(strerror(errno));
+            }
+
+            return false;
+        }
+
         QDirIterator iterator(fileInfo.filePath(),
                               QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
 
@@ -138,18 +191,327 @@ static bool renameFile(const QFileInfo &fileInfo, const QString &target, QString
     return true;
 }
 
+// 回收站目录只在每次（批量）操作开始时解析一次
+struct TrashLocation
+{
+    QString infoPath;
+    QString filesPath;
+    dev_t device = 0;
+};
+
+static bool resolveTrashLocation(TrashLocation *location, QString *errorString = NULL)
+{
+    location->infoPath = TRASH_INFO_PATH;
+    location->filesPath = TRASH_FILES_PATH;
+
+    if (!QDir().mkpath(location->infoPath) || !QDir().mkpath(location->filesPath)) {
+        if (errorString) {
+            *errorString = QString("Make the %1 path is failed").arg(TRASH_PATH);
+        }
+
+        return false;
+    }
+
+    struct stat st;
+    if (stat(QFile::encodeName(location->filesPath).constData(), &st) != 0) {
+        if (errorString) {
+            *errorString = qt_error_string(errno);
+        }
+
+        return false;
+    }
+
+    location->device = st.st_dev;
+
+    return true;
+}
+
+static bool moveFileToTrash(const TrashLocation &location, const QString &filePath, bool followSymlink, QString *errorString = NULL)
+{
+    QFileInfo fileInfo(filePath);
+
+    if (!fileInfo.exists() && (followSymlink || !fileInfo.isSymLink())) {
+        if (errorString) {
+            *errorString = QString("The %1 file is not exists").arg(filePath);
+        }
+
+        return false;
+    }
+
+    if (followSymlink && fileInfo.isSymLink()) {
+        fileInfo.setFile(fileInfo.symLinkTarget());
+    }
+
+    // 与回收站不在同一设备上的文件不能移动到该回收站
+    struct stat st;
+    if (lstat(QFile::encodeName(fileInfo.filePath()).constData(), &st) != 0 || st.st_dev != location.device) {
+        if (errorString) {
+            *errorString = QString("The %1 file is not on the device of the trash").arg(fileInfo.filePath());
+        }
+
+        return false;
+    }
+
+    const QString &fileName = getNotExistsFileName(fileInfo.fileName(), location.filesPath);
+
+    if (!writeTrashInfo(location.infoPath, fileName, fileInfo.filePath(), QDateTime::currentDateTime(), errorString)) {
+        return false;
+    }
+
+    if (!renameFile(fileInfo, location.filesPath + "/" + fileName, errorString)) {
+        QFile::remove(location.infoPath + "/" + fileName + ".trashinfo");
+        return false;
+    }
+
+    return true;
+}
+
+static QList<QByteArray> directoryEntries(int dirFd)
+{
+    QList<QByteArray> entries;
+
+    int fd = dup(dirFd);
+    if (fd < 0)
+        return entries;
+
+    DIR *dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return entries;
+    }
+
+    rewinddir(dir);
+    while (struct dirent *entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        entries << QByteArray(entry->d_name);
+    }
+
+    closedir(dir);
+
+    return entries;
+}
+
+// 删除 dirFd 下的 name，目录则递归删除，不跟随符号链接
+static bool removeAt(int dirFd, const char *name, const QAtomicInt &canceled)
+{
+    if (unlinkat(dirFd, name, 0) == 0 || errno == ENOENT)
+        return true;
+
+    // Linux 对目录返回 EISDIR，POSIX 允许返回 EPERM
+    if (errno != EISDIR && errno != EPERM)
+        return false;
+
+    int fd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    DIR *dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return false;
+    }
+
+    bool ok = true;
+    while (struct dirent *entry = readdir(dir)) {
+        if (canceled.loadAcquire()) {
+            ok = false;
+            break;
+        }
+
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        if (!removeAt(fd, entry->d_name, canceled))
+            ok = false;
+    }
+
+    closedir(dir);
+
+    if (!ok)
+        return false;
+
+    return unlinkat(dirFd, name, AT_REMOVEDIR) == 0 || errno == ENOENT;
+}
+
 class DTrashManagerPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 {
 public:
     DTrashManagerPrivate(DTrashManager *q_ptr)
         : DObjectPrivate(q_ptr) {}
 
-    static bool removeFileOrDir(const QString &path);
-    static bool removeFromIterator(QDirIterator &iter);
+    bool start(const std::function<bool()> &job);
+    void _q_onTaskFinished();
+    void _q_reportCleanProgress(int total);
+    bool moveFiles(const QStringList &filePaths, bool followSymlink);
+    bool clean(const QAtomicInt &canceled, bool notify);
+
+    QFutureWatcher<bool> *watcher = nullptr;
+    QAtomicInt canceled;
+    // 从任务开始到 finished 发出之前都为 true
+    bool running = false;
+    // clean() 的工作线程只更新计数，由 DTrashManager 所在线程按顺序发出 progressChanged
+    QAtomicInt cleanDone;
+    QAtomicInt progressPosted;
+    int reportedDone = 0;
 
     D_DECLARE_PUBLIC(DTrashManager)
 };
 
+bool DTrashManagerPrivate::start(const std::function<bool()> &job)
+{
+    if (running)
+        return false;
+
+    canceled.storeRelease(0);
+    cleanDone.storeRelease(0);
+    reportedDone = 0;
+    running = true;
+    watcher->setFuture(QtConcurrent::run([job] {
+        return job();
+    }));
+
+    return true;
+}
+
+// 由 QFutureWatcher 在 DTrashManager 所在线程调用，此时工作线程已经结束，
+// 之前排队的 progressChanged 和 itemFailed 也已先于 finished 送达
+void DTrashManagerPrivate::_q_onTaskFinished()
+{
+    D_Q(DTrashManager);
+
+    running = false;
+    Q_EMIT q->finished(watcher->result() && !canceled.loadAcquire());
+}
+
+// 发出最新的计数，之前合并掉的进度不再单独报告，因此进度不会倒退
+void DTrashManagerPrivate::_q_reportCleanProgress(int total)
+{
+    D_Q(DTrashManager);
+
+    progressPosted.storeRelease(0);
+    const int value = cleanDone.loadAcquire();
+
+    if (value > reportedDone) {
+        reportedDone = value;
+        Q_EMIT q->progressChanged(value, total);
+    }
+}
+
+bool DTrashManagerPrivate::moveFiles(const QStringList &filePaths, bool followSymlink)
+{
+    D_Q(DTrashManager);
+
+    TrashLocation location;
+    QString errorString;
+
+    if (!resolveTrashLocation(&location, &errorString)) {
+        for (const QString &filePath : filePaths)
+            Q_EMIT q->itemFailed(filePath, errorString);
+
+        return false;
+    }
+
+    bool ok = true;
+    int done = 0;
+
+    for (const QString &filePath : filePaths) {
+        if (canceled.loadAcquire())
+            return false;
+
+        if (!moveFileToTrash(location, filePath, followSymlink, &errorString)) {
+            ok = false;
+            Q_EMIT q->itemFailed(filePath, errorString);
+        }
+
+        Q_EMIT q->progressChanged(++done, filePaths.size());
+    }
+
+    return ok;
+}
+
+bool DTrashManagerPrivate::clean(const QAtomicInt &canceled, bool notify)
+{
+    D_Q(DTrashManager);
+
+    const QString infoPath = TRASH_INFO_PATH;
+    const QString filesPath = TRASH_FILES_PATH;
+
+    int filesFd = open(QFile::encodeName(filesPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    int infoFd = open(QFile::encodeName(infoPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if ((filesFd < 0 && errno != ENOENT) || (infoFd < 0 && errno != ENOENT)) {
+        if (filesFd >= 0)
+            close(filesFd);
+        if (infoFd >= 0)
+            close(infoFd);
+
+        return false;
+    }
+
+    QList<QByteArray> entries;
+    if (filesFd >= 0)
+        entries = directoryEntries(filesFd);
+
+    const int total = entries.size();
+    QAtomicInt failed;
+
+    // 每个回收站条目相互独立，交给线程池并行删除
+    QtConcurrent::blockingMap(entries, [&](const QByteArray &name) {
+        if (canceled.loadAcquire())
+            return;
+
+        if (removeAt(filesFd, name.constData(), canceled)) {
+            if (infoFd >= 0)
+                unlinkat(infoFd, QByteArray(name + ".trashinfo").constData(), 0);
+        } else {
+            const int error = errno;
+
+            if (!canceled.loadAcquire()) {
+                failed.storeRelease(1);
+
+                if (notify)
+                    Q_EMIT q->itemFailed(filesPath + "/" + QFile::decodeName(name), qt_error_string(error));
+            }
+        }
+
+        cleanDone.fetchAndAddOrdered(1);
+
+        // 已有未处理的通知时只更新计数，该通知发出时会带上最新的值
+        if (notify && progressPosted.testAndSetOrdered(0, 1)) {
+            QMetaObject::invokeMethod(q, [this, total] {
+                _q_reportCleanProgress(total);
+            }, Qt::QueuedConnection);
+        }
+    });
+
+    // 清理 files 中已没有对应条目的 trashinfo，删除失败的条目保留其 trashinfo
+    if (infoFd >= 0 && !canceled.loadAcquire()) {
+        const QByteArray suffix(".trashinfo");
+
+        for (const QByteArray &name : directoryEntries(infoFd)) {
+            if (filesFd >= 0 && name.endsWith(suffix)) {
+                struct stat st;
+                const QByteArray fileName = name.left(name.size() - suffix.size());
+
+                if (fstatat(filesFd, fileName.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0 || errno != ENOENT)
+                    continue;
+            }
+
+            if (unlinkat(infoFd, name.constData(), 0) != 0 && errno != ENOENT)
+                failed.storeRelease(1);
+        }
+    }
+
+    if (filesFd >= 0)
+        close(filesFd);
+    if (infoFd >= 0)
+        close(infoFd);
+
+    return !failed.loadAcquire() && !canceled.loadAcquire();
+}
+
 DTrashManager *DTrashManager::instance()
 {
     return globalTrashManager;
@@ -166,87 +528,90 @@ bool DTrashManager::trashIsEmpty() const
 
 bool DTrashManager::cleanTrash()
 {
-    QDirIterator iterator_info(TRASH_INFO_PATH,
-                               QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden);
-
-    QDirIterator iterator_files(TRASH_FILES_PATH,
-                                QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
-                                QDirIterator::Subdirectories);
+    D_D(DTrashManager);
 
-    return DTrashManagerPrivate::removeFromIterator(iterator_info) &&
-           DTrashManagerPrivate::removeFromIterator(iterator_files);
+    const QAtomicInt canceled(0);
+    return d->clean(canceled, false);
 }
 
 bool DTrashManager::moveToTrash(const QString &filePath, bool followSymlink)
 {
-    QFileInfo fileInfo(filePath);
+    TrashLocation location;
 
-    if (!fileInfo.exists() && (followSymlink || !fileInfo.isSymLink())) {
+    if (!resolveTrashLocation(&location)) {
         return false;
     }
 
-    QDir trashDir(TRASH_FILES_PATH);
-    QStorageInfo storageInfo(fileInfo.filePath());
-    QStorageInfo trashStorageInfo(trashDir);
+    return moveFileToTrash(location, filePath, followSymlink);
+}
 
-    if (storageInfo != trashStorageInfo) {
-        return false;
-    }
+/*!
+  \brief 在工作线程中批量移动 \a filePaths 到回收站.
 
-    if (!trashDir.mkpath(TRASH_INFO_PATH)) {
-        return false;
-    }
+  回收站目录只解析一次，每个文件的结果通过 itemFailed 和 progressChanged 报告，
+  全部完成或被 cancel 后，在 DTrashManager 所在线程发出 finished。
+  已有任务尚未发出 finished 时返回 false。
+ */
+bool DTrashManager::moveToTrash(const QStringList &filePaths, bool followSymlink)
+{
+    D_D(DTrashManager);
 
-    if (!trashDir.mkpath(TRASH_FILES_PATH)) {
-        return false;
-    }
+    return d->start([d, filePaths, followSymlink] {
+        return d->moveFiles(filePaths, followSymlink);
+    });
+}
 
-    if (followSymlink && fileInfo.isSymLink()) {
-        fileInfo.setFile(fileInfo.symLinkTarget());
-    }
+/*!
+  \brief 在工作线程中清空回收站，各条目并行删除.
 
-    const QString &fileName = getNotExistsFileName(fileInfo.fileName(), TRASH_FILES_PATH);
+  progressChanged 在 DTrashManager 所在线程按递增顺序发出，连续完成的条目可能合并为
+  一次通知，最后一次通知的 done 等于条目总数。
+  已有任务尚未发出 finished 时返回 false。
+ */
+bool DTrashManager::cleanTrashAsync()
+{
+    D_D(DTrashManager);
 
-    if (!writeTrashInfo(fileName, fileInfo.filePath(), QDateTime::currentDateTime())) {
-        return false;
-    }
+    return d->start([d] {
+        return d->clean(d->canceled, true);
+    });
+}
 
-    const QString &newFilePath = TRASH_FILES_PATH"/" + fileName;
+bool DTrashManager::isRunning() const
+{
+    D_DC(DTrashManager);
 
-    return renameFile(fileInfo, newFilePath);
+    return d->running;
+}
+
+void DTrashManager::cancel()
+{
+    D_D(DTrashManager);
+
+    d->canceled.storeRelease(1);
 }
 
 DTrashManager::DTrashManager()
     : QObject()
     , DObject(*new DTrashManagerPrivate(this))
 {
+    D_D(DTrashManager);
 
+    d->watcher = new QFutureWatcher<bool>(this);
+    connect(d->watcher, &QFutureWatcherBase::finished, this, [d] {
+        d->_q_onTaskFinished();
+    });
 }
 
-bool DTrashManagerPrivate::removeFileOrDir(const QString &path)
+DTrashManager::~DTrashManager()
 {
-    QFileInfo fileInfo(path);
-    if (fileInfo.isDir() && !fileInfo.isSymLink()) {
-        QDir dir(path);
-        return dir.removeRecursively();
-    } else {
-        return QFile::remove(path);
-    }
-}
+    D_D(DTrashManager);
 
-bool DTrashManagerPrivate::removeFromIterator(QDirIterator &iter)
-{
-    bool ok = true;
-    while (iter.hasNext()) {
-        QString nextPath = iter.next();
-//        qDebug() << iter.fileName() << iterator_info.filePath();
-        if (!DTrashManagerPrivate::removeFileOrDir(nextPath)) {
-            ok = false;
-        }
-    }
-    return ok;
+    d->canceled.storeRelease(1);
+    d->watcher->waitForFinished();
 }
 
 DWIDGET_END_NAMESPACE
 
+#include "moc_dtrashmanager.cpp"
 #endif
@@ -131,10 +131,36 @@ bool DTrashManager::cleanTrash()
 }
 
 bool DTrashManager::moveToTrash(const QString &filePath, bool followSymlink)
+{
+    Q_UNUSED(filePath);
+    Q_UNUSED(followSymlink);
+
+    return false;
+}
+
+bool DTrashManager::moveToTrash(const QStringList &filePaths, bool followSymlink)
+{
+    Q_UNUSED(filePaths);
+    Q_UNUSED(followSymlink);
+
+    return false;
+}
+
+bool DTrashManager::cleanTrashAsync()
+{
+    return false;
+}
+
+bool DTrashManager::isRunning() const
 {
     return false;
 }
 
+void DTrashManager::cancel()
+{
+
+}
+
 DTrashManager::DTrashManager()
     : QObject()
     , DObject(*new DTrashManagerPrivate(this))
@@ -142,6 +168,11 @@ DTrashManager::DTrashManager()
 
 }
 
+DTrashManager::~DTrashManager()
+{
+
+}
+
 DWIDGET_END_NAMESPACE
 
 #endif
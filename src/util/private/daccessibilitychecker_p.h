@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DACCESSIBILITYCHECKER_P_H
+#define DACCESSIBILITYCHECKER_P_H
+
+#include "daccessibilitychecker.h"
+
+#include <DObjectPrivate>
+
+#include <QAbstractItemView>
+#include <QChildEvent>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+DWIDGET_BEGIN_NAMESPACE
+
+class DAccessibilityCheckerEventFilter;
+class DAccessibilityCheckerPrivate : public DCORE_NAMESPACE::DObjectPrivate
+{
+    D_DECLARE_PUBLIC(DAccessibilityChecker)
+public:
+    enum WidgetStatus {
+        Passed,
+        Failed,
+        Ignored
+    };
+
+    DAccessibilityCheckerPrivate(DAccessibilityChecker *qq);
+    bool check();
+
+    void checkWidgetName();
+    void checkViewItemName();
+    bool isIgnore(DAccessibilityChecker::Role role, const QWidget *w);
+
+    void widgetAdded(QWidget *w);
+    void widgetRemoved(QObject *object);
+    void widgetDestroyed(QObject *object);
+
+private:
+    // 以地址为键，控件销毁时移除；QPointer 用于识别地址被新控件复用的情况
+    struct WidgetState {
+        QPointer<QWidget> widget;
+        WidgetStatus status;
+    };
+
+    struct ViewState {
+        QPointer<QAbstractItemView> view;
+        QPointer<QAbstractItemModel> model;
+        QList<QMetaObject::Connection> connections;
+        QVector<QPair<int, int>> dirtyRows;
+        QSet<int> failedRows;
+    };
+
+    WidgetStatus checkWidget(QWidget *w);
+    int checkViewItems(QAbstractItemView *view, int firstRow, int lastRow, QStringList *warnings);
+    bool checkViewItemNameFromAccessibleInteface(QAbstractItemView *listview, int firstRow, int lastRow, int *failedCount, QStringList *warnings);
+    bool checkViewItemNameFromAccessibleText(QAbstractItemView *listview, int firstRow, int lastRow, int *failedCount, QStringList *warnings);
+    int viewRowCount(QAbstractItemView *view) const;
+
+    void ensureEventFilter();
+    void checkIncrementally();
+    bool processIncrementalChecks(bool *checked);
+    void syncTopLevelWidgets();
+    void checkWidgetIncrementally(QWidget *w);
+    bool isTracked(const QObject *object) const;
+    bool isWatchedView(const QObject *view) const;
+    void setWidgetStatus(QWidget *w, WidgetStatus status);
+    void forgetWidget(QObject *object);
+    void watchView(QAbstractItemView *view);
+    void watchModel(ViewState &state);
+    void resetView(QObject *view);
+    void insertViewRows(QObject *view, const QModelIndex &parent, int first, int last);
+    void removeViewRows(QObject *view, const QModelIndex &parent, int first, int last);
+    void markViewRowsDirty(QObject *view, const QModelIndex &parent, int first, int last);
+    bool checkDirtyViewRows(const QElapsedTimer &timer);
+    void collectIncrementalResult();
+
+    bool isDefaultIgnoreWidget(const QWidget *w) const;
+    bool isDefaultIgnoreView(const QAbstractItemView *view) const;
+
+    QString widgetOutputLog(const QWidget *w) const;
+    QString widgetInfoString(const QWidget *w) const;
+    QString viewItemOutputLog(int rowIndex, int columnIndex, const QAbstractItemView *absView, const QString &itemText = QString()) const;
+
+    void formatCheckResult();
+    void printSummaryResults();
+    void printRoleWarningOutput(const QString &roleString, const QStringList &roleList);
+    void _q_checkTimeout();
+
+private:
+    QWidgetList topLevelWidgets;
+    QStringList widgetsWarningList;
+    QStringList itemWariningList;
+    DAccessibilityChecker::OutputFormat outputFormat;
+    QTimer *checkTimer;
+    int widgetCount;
+    int widgetIgnoredCount;
+
+    // 增量检查的状态，由 ChildAdded/ChildRemoved、destroyed 和 model 信号驱动
+    DAccessibilityCheckerEventFilter *eventFilter;
+    QSet<QObject *> knownTopLevelWidgets;
+    QList<QPointer<QWidget>> pendingWidgets;
+    QHash<QObject *, WidgetState> widgetStates;
+    QHash<QObject *, ViewState> views;
+    bool continuationScheduled;
+};
+
+/*!
+   \internal
+   \brief 监听所有控件的子控件增删，安装在 qApp 上.
+ */
+class DAccessibilityCheckerEventFilter : public QObject
+{
+public:
+    DAccessibilityCheckerEventFilter(DAccessibilityCheckerPrivate *dd, QObject *parent)
+        : QObject(parent)
+        , d(dd)
+    {
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved) {
+            QObject *child = static_cast<QChildEvent *>(event)->child();
+
+            if (watched->isWidgetType() && child->isWidgetType()) {
+                if (event->type() == QEvent::ChildAdded) {
+                    d->widgetAdded(static_cast<QWidget *>(child));
+                } else {
+                    d->widgetRemoved(child);
+                }
+            }
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+
+    void widgetDestroyed(QObject *object)
+    {
+        d->widgetDestroyed(object);
+    }
+
+private:
+    DAccessibilityCheckerPrivate *d;
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DACCESSIBILITYCHECKER_P_H
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DFILEICONPROVIDER_P_H
+#define DFILEICONPROVIDER_P_H
+
+#include <dtkwidget_global.h>
+
+#include <QCache>
+#include <QFileInfo>
+#include <QIcon>
+#include <QMimeDatabase>
+#include <QMutex>
+
+DWIDGET_BEGIN_NAMESPACE
+
+// 文件 -> mime 类型 -> 图标的两级 LRU 缓存，异步查询的工作线程与 provider 共享
+class DFileIconCache
+{
+public:
+    QString mimeTypeName(const QFileInfo &info, QMimeDatabase::MatchMode mode);
+    QIcon mimeTypeIcon(const QString &mimeTypeName);
+    QIcon icon(const QString &key);
+    void insertIcon(const QString &key, const QIcon &icon);
+    void clear();
+
+    static QString fileKey(const QFileInfo &info, QMimeDatabase::MatchMode mode);
+
+private:
+    void checkIconTheme();
+
+    QMutex mutex;
+    QMimeDatabase mimeDatabase;
+    QCache<QString, QString> mimeTypeNames { 4096 };
+    QCache<QString, QIcon> icons { 512 };
+    QString iconThemeName;
+};
+
+
+DWIDGET_END_NAMESPACE
+
+#endif // DFILEICONPROVIDER_P_H
@@ -6,6 +6,9 @@
 
 #include "denhancedwidget.h"
 
+#include <QHash>
+#include <QSet>
+
 DWIDGET_BEGIN_NAMESPACE
 
 /*!
@@ -63,10 +66,14 @@ DWIDGET_BEGIN_NAMESPACE
   Implementation of.
   
   \section1 loop_anchor
-  Suppose DAnchorsBase a1, a2; a1.setRight(a2.left());  I'm going to say between a1 and a2
-  The logic for whether there is a loop binding is:
-  Try to change the value of the right boundary of a1. If the value of the left boundary of a2 changes after the update, it is considered to cause a loop tie
-  Sure, otherwise it is considered not to exist
+  The anchors form a dependency graph: the vertical (horizontal) geometry of a control depends on
+  the controls its top, verticalCenter and bottom (left, horizontalCenter and right) anchor lines are
+  bound to, and fill/centerIn depend on the whole geometry of their target.
+  Suppose DAnchorsBase a1, a2; a1.setRight(a2.left()); the binding is rejected with LoopBind
+  if a2 already depends on a1 in the horizontal direction.
+  \section1 anchor_update
+  When the geometry of a control changes, the controls that depend on it are sorted topologically
+  and each of them is updated once, after all the controls it depends on.
  */
 
 /*!
@@ -382,6 +389,8 @@ public:
     DAnchorsBasePrivate(DAnchorsBase *qq): q_ptr(qq) {}
     ~DAnchorsBasePrivate()
     {
+        invalidateGraph();
+
         delete top;
         delete bottom;
         delete left;
@@ -398,6 +407,7 @@ public:
                 bb->deleteLater();
             }
             widgetMap[w] = b;
+            invalidateGraph();
         }
     }
     static DAnchorsBase *getWidgetAnchorsBase(const QWidget *w)
@@ -408,6 +418,7 @@ public:
     {
         if (w && b && widgetMap.value(w, NULL) == b) {
             widgetMap.remove(w);
+            invalidateGraph();
         }
     }
 
@@ -595,6 +606,78 @@ public:
         return count;
     }
 
+    // 目标控件只能是父控件或者父控件下的子孙控件，沿父控件链向上查找即可
+    bool isAnchorableTarget(const QWidget *w) const
+    {
+        Q_Q(const DAnchorsBase);
+        const QWidget *parent = q->target()->parentWidget();
+
+        if (!parent)
+            return false;
+
+        for (const QWidget *p = w; p; p = p->parentWidget()) {
+            if (p == parent)
+                return true;
+        }
+
+        return false;
+    }
+    static Qt::Orientation axisOf(Qt::AnchorPoint p)
+    {
+        switch (p) {
+        case Qt::AnchorTop://Deliberate
+        case Qt::AnchorBottom://Deliberate
+        case Qt::AnchorVerticalCenter:
+            return Qt::Vertical;
+        default:
+            return Qt::Horizontal;
+        }
+    }
+    // 锚定关系构成一个有向图，节点为控件在某一方向上的几何信息，边由锚线及 fill/centerIn 确定
+    void appendDependencies(QVector<const DAnchorsBasePrivate *> &list, Qt::Orientation axis) const
+    {
+        const DAnchorInfo *infos[] = { top, verticalCenter, bottom, left, horizontalCenter, right };
+
+        for (const DAnchorInfo *info : infos) {
+            if (info->targetInfo && axisOf(info->type) == axis)
+                list << info->targetInfo->base->d_func();
+        }
+
+        for (const DEnhancedWidget *w : { fill, centerIn }) {
+            if (const DAnchorsBase *base = getWidgetAnchorsBase(w->target()))
+                list << base->d_func();
+        }
+    }
+    // 深度优先遍历依赖图，判断 from 是否（间接）依赖于当前对象，复杂度为 O(V+E)
+    bool dependsOn(const DAnchorsBasePrivate *from, Qt::Orientation axis) const
+    {
+        QSet<const DAnchorsBasePrivate *> visited;
+        QVector<const DAnchorsBasePrivate *> stack { from };
+
+        while (!stack.isEmpty()) {
+            const DAnchorsBasePrivate *node = stack.takeLast();
+
+            if (node == this)
+                return true;
+
+            if (visited.contains(node))
+                continue;
+
+            visited.insert(node);
+            node->appendDependencies(stack, axis);
+        }
+
+        return false;
+    }
+    bool widgetDependsOn(const QWidget *w) const
+    {
+        const DAnchorsBase *base = getWidgetAnchorsBase(w);
+
+        if (!base)
+            return false;
+
+        return dependsOn(base->d_func(), Qt::Horizontal) || dependsOn(base->d_func(), Qt::Vertical);
+    }
     int verticalAnchorCount() const
     {
         Q_Q(const DAnchorsBase);
@@ -610,6 +693,54 @@ public:
         return count;
     }
 
+    // 求解器中的一个节点是某个锚定对象在一个方向上的更新，fill 和 centerIn 同时决定两个方向
+    enum UpdateKind {
+        VerticalUpdate = 0x1,
+        HorizontalUpdate = 0x2,
+        RectUpdate = 0x4
+    };
+    typedef QPair<DAnchorsBasePrivate *, int> Node;
+    // 控件在某一方向上的几何，是节点之间的边
+    typedef QPair<const QWidget *, int> Edge;
+
+    struct PendingUpdate {
+        QPointer<QWidget> changed;
+        QPointer<DAnchorsBase> base;
+        int kinds;
+    };
+
+    static UpdateKind updateKindOf(Qt::AnchorPoint p)
+    {
+        return axisOf(p) == Qt::Vertical ? VerticalUpdate : HorizontalUpdate;
+    }
+    static QVector<int> updateAxes(int kind)
+    {
+        switch (kind) {
+        case VerticalUpdate:
+            return { Qt::Vertical };
+        case HorizontalUpdate:
+            return { Qt::Horizontal };
+        default:
+            return { Qt::Vertical, Qt::Horizontal };
+        }
+    }
+    QVector<const QWidget *> inputWidgets(int kind) const;
+    bool dependsOnOwnSize(int kind) const;
+
+    void update(int kinds);
+    void geometryChanged(const DEnhancedWidget *sender, UpdateKind kind);
+    void applyUpdate(int kind);
+    void updateVertical();
+    void updateHorizontal();
+    void updateFill();
+    void updateCenterIn();
+
+    static void invalidateGraph();
+    static void buildGraph();
+    static void visit(const Node &node, QSet<Node> *visited, QVector<Node> *order);
+    static void solve(QWidget *changed, const QVector<Node> &roots);
+    static void runPendingUpdates();
+
     DAnchorsBase *q_ptr;
 
     QPointer<DEnhancedWidget> extendWidget;
@@ -633,10 +764,26 @@ public:
     QString errorString;
     static QMap<const QWidget *, DAnchorsBase *> widgetMap;
 
+    // 依赖图：控件某一方向的几何 -> 依赖它的节点，锚定关系变化时重建
+    static QHash<Edge, QVector<Node>> consumers;
+    static bool graphDirty;
+    static bool solving;
+    static QSet<const QWidget *> solvingWidgets;
+    static QList<PendingUpdate> pendingUpdates;
+    static QPointer<QWidget> lastChangedWidget;
+    static QRect lastChangedGeometry;
+
     Q_DECLARE_PUBLIC(DAnchorsBase)
 };
 
 QMap<const QWidget *, DAnchorsBase *> DAnchorsBasePrivate::widgetMap;
+QHash<DAnchorsBasePrivate::Edge, QVector<DAnchorsBasePrivate::Node>> DAnchorsBasePrivate::consumers;
+bool DAnchorsBasePrivate::graphDirty = true;
+bool DAnchorsBasePrivate::solving = false;
+QSet<const QWidget *> DAnchorsBasePrivate::solvingWidgets;
+QList<DAnchorsBasePrivate::PendingUpdate> DAnchorsBasePrivate::pendingUpdates;
+QPointer<QWidget> DAnchorsBasePrivate::lastChangedWidget;
+QRect DAnchorsBasePrivate::lastChangedGeometry;
 
 /*!
 @~english
@@ -994,56 +1141,24 @@ bool DAnchorsBase::setAnchor(const Qt::AnchorPoint &p, QWidget *target, const Qt
             d->errorCode = TargetInvalid;\
             d->errorString = "Cannot anchor widget to self.";\
             return false;\
-        }else if(target()->parentWidget() != point->base->target()){\
-            bool isBrother = false;\
-            Q_FOREACH (const QWidget *w, target()->parentWidget()->findChildren<QWidget*>()) {\
-                if(w == point->base->target()){\
-                    isBrother = true;\
-                    break;\
-                }\
-            }\
-            if(!isBrother){\
-                d->errorCode = TargetInvalid;\
-                d->errorString = "Cannot anchor to an widget that isn't a parent or sibling.";\
-                return false;\
-            }\
+        }else if(!d->isAnchorableTarget(point->base->target())){\
+            d->errorCode = TargetInvalid;\
+            d->errorString = "Cannot anchor to an widget that isn't a parent or sibling.";\
+            return false;\
         }\
         if(!d->checkInfo(d->point, point)){\
             d->errorCode = PointInvalid;\
             d->errorString = "Cannot anchor a vertical/horizontal edge to a horizontal/vertical edge.";\
             return false;\
         }\
-        int old_pos = d->getValueByInfo(point);\
-        DAnchorInfo old_info = *d->point;\
-        *d->point = point;\
-        slotName();\
-        if(old_pos != d->getValueByInfo(point)){\
-            *d->point = old_info;\
-            slotName();\
-            d->errorCode = PointInvalid;\
+        if(d->dependsOn(point->base->d_func(), d->axisOf(d->point->type))){\
+            d->errorCode = LoopBind;\
             d->errorString = "loop bind.";\
             return false;\
-        }else{\
-            old_pos = d->getValueByInfo(d->point);\
-            int target_old_value = d->getValueByInfo(point);\
-            /*保存widget当然的一些标志位，setValueByInfo仅仅是尝试设置，调用之后要复原标志位*/\
-            bool moved = point->base->target()->testAttribute(Qt::WA_Moved);\
-            bool resized = point->base->target()->testAttribute(Qt::WA_Resized);\
-            d->setValueByInfo(target_old_value + 1, point);\
-            if(old_pos != d->getValueByInfo(d->point)){\
-                *d->point = old_info;\
-                slotName();\
-                d->setValueByInfo(target_old_value, point);\
-                point->base->target()->setAttribute(Qt::WA_Moved, moved);\
-                point->base->target()->setAttribute(Qt::WA_Resized, resized);\
-                d->errorCode = PointInvalid;\
-                d->errorString = "loop bind.";\
-                return false;\
-            }\
-            d->setValueByInfo(target_old_value, point);\
-            point->base->target()->setAttribute(Qt::WA_Moved, moved);\
-            point->base->target()->setAttribute(Qt::WA_Resized, resized);\
         }\
+        *d->point = point;\
+        DAnchorsBasePrivate::invalidateGraph();\
+        d->update(d->updateKindOf(d->point->type));\
         tmp_w2 = point->base->d_func()->extendWidget;\
         if(tmp_w1 != tmp_w2){\
             Q_FOREACH(QString str, signalList){\
@@ -1067,6 +1182,7 @@ bool DAnchorsBase::setAnchor(const Qt::AnchorPoint &p, QWidget *target, const Qt
             disconnect(tmp_w1, SIGNAL(showed()), d->q_func(), SLOT(slotName()));\
         }\
         *d->point = point;\
+        DAnchorsBasePrivate::invalidateGraph();\
     }\
     if((isBinding(d->right) || isBinding(d->horizontalCenter)) && d->horizontalAnchorCount() == 1)\
     {connect(d->extendWidget, SIGNAL(widthChanged(int)), d->q_func(), SLOT(updateHorizontal()));}\
@@ -1085,31 +1201,19 @@ bool DAnchorsBase::setAnchor(const Qt::AnchorPoint &p, QWidget *target, const Qt
             d->errorCode = TargetInvalid;\
             d->errorString = "Cannot anchor widget to self.";\
             return false;\
-        }else if(target()->parentWidget() != point){\
-            bool isBrother = false;\
-            Q_FOREACH (const QWidget *w, target()->parentWidget()->findChildren<QWidget*>()) {\
-                if(w == point){\
-                    isBrother = true;\
-                    break;\
-                }\
-            }\
-            if(!isBrother){\
-                d->errorCode = TargetInvalid;\
-                d->errorString = "Cannot anchor to an widget that isn't a parent or sibling.";\
-                return false;\
-            }\
+        }else if(!d->isAnchorableTarget(point)){\
+            d->errorCode = TargetInvalid;\
+            d->errorString = "Cannot anchor to an widget that isn't a parent or sibling.";\
+            return false;\
         }\
-        QRect old_rect = point->geometry();\
-        QWidget *old_widget = d->point->target();\
-        d->point->setTarget(point);\
-        update##Point();\
-        if(old_rect != point->geometry()){\
-            d->point->setTarget(old_widget);\
-            update##Point();\
-            d->errorCode = PointInvalid;\
+        if(d->widgetDependsOn(point)){\
+            d->errorCode = LoopBind;\
             d->errorString = "loop bind.";\
             return false;\
         }\
+        d->point->setTarget(point);\
+        DAnchorsBasePrivate::invalidateGraph();\
+        d->update(DAnchorsBasePrivate::RectUpdate);\
         DAnchorInfo *info = NULL;\
         setTop(info);setLeft(info);setRight(info);setBottom(info);setHorizontalCenter(info);setVerticalCenter(info);setCenterIn((QWidget*)NULL);\
         if(d->point == d->fill)\
@@ -1119,6 +1223,7 @@ bool DAnchorsBase::setAnchor(const Qt::AnchorPoint &p, QWidget *target, const Qt
         else connect(d->point, SIGNAL(positionChanged(QPoint)), d->q_func(), SLOT(update##Point()));\
     }\
     d->point->setTarget(point);\
+    DAnchorsBasePrivate::invalidateGraph();\
     if(d->centerIn){connect(d->extendWidget, SIGNAL(sizeChanged(QSize)), d->q_func(), SLOT(updateCenterIn()));}\
     else disconnect(d->extendWidget, SIGNAL(sizeChanged(QSize)), d->q_func(), SLOT(updateCenterIn()));\
     Q_EMIT point##Changed(point);\
@@ -1208,10 +1313,9 @@ void DAnchorsBase::setMargins(int margins)
 
     if (margins != 0) {
         if (d->fill->target()) {
-            updateFill();
+            d->update(DAnchorsBasePrivate::RectUpdate);
         } else {
-            updateVertical();
-            updateHorizontal();
+            d->update(DAnchorsBasePrivate::VerticalUpdate | DAnchorsBasePrivate::HorizontalUpdate);
         }
     }
 
@@ -1229,9 +1333,9 @@ void DAnchorsBase::setTopMargin(int topMargin)
     d->topMargin = topMargin;
 
     if (d->fill->target()) {
-        updateFill();
+        d->update(DAnchorsBasePrivate::RectUpdate);
     } else if (isBinding(d->top)) {
-        updateVertical();
+        d->update(DAnchorsBasePrivate::VerticalUpdate);
     }
 
     Q_EMIT topMarginChanged(topMargin);
@@ -1248,9 +1352,9 @@ void DAnchorsBase::setBottomMargin(int bottomMargin)
     d->bottomMargin = bottomMargin;
 
     if (d->fill->target()) {
-        updateFill();
+        d->update(DAnchorsBasePrivate::RectUpdate);
     } else if (isBinding(d->bottom)) {
-        updateVertical();
+        d->update(DAnchorsBasePrivate::VerticalUpdate);
     }
 
     Q_EMIT bottomMarginChanged(bottomMargin);
@@ -1267,9 +1371,9 @@ void DAnchorsBase::setLeftMargin(int leftMargin)
     d->leftMargin = leftMargin;
 
     if (d->fill->target()) {
-        updateFill();
+        d->update(DAnchorsBasePrivate::RectUpdate);
     } else if (isBinding(d->left)) {
-        updateHorizontal();
+        d->update(DAnchorsBasePrivate::HorizontalUpdate);
     }
 
     Q_EMIT leftMarginChanged(leftMargin);
@@ -1286,10 +1390,10 @@ void DAnchorsBase::setRightMargin(int rightMargin)
     d->rightMargin = rightMargin;
 
     if (isBinding(d->right)) {
-        updateHorizontal();
+        d->update(DAnchorsBasePrivate::HorizontalUpdate);
     }
     if (d->fill->target()) {
-        updateFill();
+        d->update(DAnchorsBasePrivate::RectUpdate);
     }
 
     Q_EMIT rightMarginChanged(rightMargin);
@@ -1306,7 +1410,7 @@ void DAnchorsBase::setHorizontalCenterOffset(int horizontalCenterOffset)
     d->horizontalCenterOffset = horizontalCenterOffset;
 
     if (isBinding(d->horizontalCenter)) {
-        updateHorizontal();
+        d->update(DAnchorsBasePrivate::HorizontalUpdate);
     }
 
     Q_EMIT horizontalCenterOffsetChanged(horizontalCenterOffset);
@@ -1323,7 +1427,7 @@ void DAnchorsBase::setVerticalCenterOffset(int verticalCenterOffset)
     d->verticalCenterOffset = verticalCenterOffset;
 
     if (isBinding(d->verticalCenter)) {
-        updateVertical();
+        d->update(DAnchorsBasePrivate::VerticalUpdate);
     }
 
     Q_EMIT verticalCenterOffsetChanged(verticalCenterOffset);
@@ -1454,61 +1558,335 @@ void DAnchorsBase::moveCenter(const QPoint &arg)
 }
 
 #define UPDATE_GEOMETRY(p1,P1,p2,P2,p3,P3)\
-    Q_D(DAnchorsBase);\
-    if(isBinding(d->p1)){\
-        int p1##Value = d->getTargetValueByInfo(d->p1);\
-        move##P1(p1##Value);\
-        if(isBinding(d->p2)){\
-            qreal value = d->getTargetValueByInfo(d->p2);\
-            set##P3(2 * value - p1##Value, Qt::Anchor##P1);\
-        }else if(isBinding(d->p3)){\
-            set##P3(d->getTargetValueByInfo(d->p3), Qt::Anchor##P1);\
+    Q_Q(DAnchorsBase);\
+    if(q->isBinding(p1)){\
+        int p1##Value = getTargetValueByInfo(p1);\
+        q->move##P1(p1##Value);\
+        if(q->isBinding(p2)){\
+            qreal value = getTargetValueByInfo(p2);\
+            q->set##P3(2 * value - p1##Value, Qt::Anchor##P1);\
+        }else if(q->isBinding(p3)){\
+            q->set##P3(getTargetValueByInfo(p3), Qt::Anchor##P1);\
         }\
-    }else if(isBinding(d->p3)){\
-        int p3##Value = d->getTargetValueByInfo(d->p3);\
-        move##P3(p3##Value);\
-        if(isBinding(d->p2)){\
-            qreal value = d->getTargetValueByInfo(d->p2);\
-            set##P1(2 * value - p3##Value, Qt::Anchor##P1);\
+    }else if(q->isBinding(p3)){\
+        int p3##Value = getTargetValueByInfo(p3);\
+        q->move##P3(p3##Value);\
+        if(q->isBinding(p2)){\
+            qreal value = getTargetValueByInfo(p2);\
+            q->set##P1(2 * value - p3##Value, Qt::Anchor##P1);\
         }\
-    }else if(isBinding(d->p2)){\
-        move##P2(d->getTargetValueByInfo(d->p2));\
+    }else if(q->isBinding(p2)){\
+        q->move##P2(getTargetValueByInfo(p2));\
     }\
 
-void DAnchorsBase::updateVertical()
+void DAnchorsBasePrivate::updateVertical()
 {
     UPDATE_GEOMETRY(top, Top, verticalCenter, VerticalCenter, bottom, Bottom)
 }
 
-void DAnchorsBase::updateHorizontal()
+void DAnchorsBasePrivate::updateHorizontal()
 {
     UPDATE_GEOMETRY(left, Left, horizontalCenter, HorizontalCenter, right, Right)
 }
 
-void DAnchorsBase::updateFill()
+void DAnchorsBasePrivate::updateFill()
 {
-    Q_D(DAnchorsBase);
+    Q_Q(DAnchorsBase);
 
-    QRect rect = d->getWidgetRect(d->fill->target());
-    int offset = d->topMargin != 0 ? d->topMargin : d->margins;
+    QRect rect = getWidgetRect(fill->target());
+    int offset = topMargin != 0 ? topMargin : margins;
     rect.setTop(rect.top() + offset);
-    offset = d->bottomMargin != 0 ? d->bottomMargin : d->margins;
+    offset = bottomMargin != 0 ? bottomMargin : margins;
     rect.setBottom(rect.bottom() - offset);
-    offset = d->leftMargin != 0 ? d->leftMargin : d->margins;
+    offset = leftMargin != 0 ? leftMargin : margins;
     rect.setLeft(rect.left() + offset);
-    offset = d->rightMargin != 0 ? d->rightMargin : d->margins;
+    offset = rightMargin != 0 ? rightMargin : margins;
     rect.setRight(rect.right() - offset);
 
-    target()->setFixedSize(rect.size());
-    target()->move(rect.topLeft());
+    q->target()->setFixedSize(rect.size());
+    q->target()->move(rect.topLeft());
+}
+
+void DAnchorsBasePrivate::updateCenterIn()
+{
+    Q_Q(DAnchorsBase);
+
+    QRect rect = getWidgetRect(centerIn->target());
+    q->moveCenter(rect.center());
+}
+
+void DAnchorsBasePrivate::applyUpdate(int kind)
+{
+    switch (kind) {
+    case VerticalUpdate:
+        updateVertical();
+        break;
+    case HorizontalUpdate:
+        updateHorizontal();
+        break;
+    default:
+        if (fill->target()) {
+            updateFill();
+        } else if (centerIn->target()) {
+            updateCenterIn();
+        }
+        break;
+    }
+}
+
+QVector<const QWidget *> DAnchorsBasePrivate::inputWidgets(int kind) const
+{
+    QVector<const QWidget *> list;
+
+    if (kind == RectUpdate) {
+        if (const QWidget *w = fill->target() ? fill->target() : centerIn->target())
+            list << w;
+
+        return list;
+    }
+
+    const DAnchorInfo *infos[] = { top, verticalCenter, bottom, left, horizontalCenter, right };
+
+    for (const DAnchorInfo *info : infos) {
+        if (!info->targetInfo || updateKindOf(info->type) != kind)
+            continue;
+
+        if (const QWidget *w = info->targetInfo->base->target())
+            list << w;
+    }
+
+    return list;
+}
+
+// 只锚定了 bottom/right 或中心线时，位置还取决于控件自身的尺寸
+bool DAnchorsBasePrivate::dependsOnOwnSize(int kind) const
+{
+    Q_Q(const DAnchorsBase);
+
+    switch (kind) {
+    case VerticalUpdate:
+        return (q->isBinding(bottom) || q->isBinding(verticalCenter)) && verticalAnchorCount() == 1;
+    case HorizontalUpdate:
+        return (q->isBinding(right) || q->isBinding(horizontalCenter)) && horizontalAnchorCount() == 1;
+    default:
+        return !fill->target() && centerIn->target();
+    }
+}
+
+void DAnchorsBasePrivate::invalidateGraph()
+{
+    graphDirty = true;
+    lastChangedWidget.clear();
+}
+
+void DAnchorsBasePrivate::buildGraph()
+{
+    consumers.clear();
+
+    for (DAnchorsBase *base : qAsConst(widgetMap)) {
+        DAnchorsBasePrivate *d = base->d_func();
+
+        for (int kind : { VerticalUpdate, HorizontalUpdate, RectUpdate }) {
+            const Node node(d, kind);
+
+            for (const QWidget *w : d->inputWidgets(kind)) {
+                for (int axis : updateAxes(kind)) {
+                    QVector<Node> &list = consumers[Edge(w, axis)];
+
+                    if (!list.contains(node))
+                        list << node;
+                }
+            }
+        }
+    }
+
+    graphDirty = false;
+}
+
+// 深度优先遍历，节点在所有依赖它的节点之后加入 order，反序即为拓扑序
+void DAnchorsBasePrivate::visit(const Node &node, QSet<Node> *visited, QVector<Node> *order)
+{
+    // fill/centerIn 跨方向的依赖可能构成回边，此时忽略该边
+    if (visited->contains(node))
+        return;
+
+    visited->insert(node);
+
+    DAnchorsBasePrivate *d = node.first;
+
+    // 禁用后不再发出几何变化信号，依赖它的控件也不随之更新
+    if (d->extendWidget && d->extendWidget->enabled()) {
+        const QWidget *w = d->extendWidget->target();
+
+        for (int axis : updateAxes(node.second)) {
+            for (const Node &consumer : consumers.value(Edge(w, axis)))
+                visit(consumer, visited, order);
+        }
+    }
+
+    order->append(node);
+}
+
+void DAnchorsBasePrivate::solve(QWidget *changed, const QVector<Node> &roots)
+{
+    if (graphDirty)
+        buildGraph();
+
+    QSet<Node> visited;
+    QVector<Node> order;
+
+    for (const Node &node : roots)
+        visit(node, &visited, &order);
+
+    if (changed) {
+        if (DAnchorsBase *base = getWidgetAnchorsBase(changed)) {
+            DAnchorsBasePrivate *d = base->d_func();
+
+            for (int kind : { VerticalUpdate, HorizontalUpdate, RectUpdate }) {
+                if (d->dependsOnOwnSize(kind))
+                    visit(Node(d, kind), &visited, &order);
+            }
+        }
+
+        for (int axis : { Qt::Vertical, Qt::Horizontal }) {
+            for (const Node &node : consumers.value(Edge(changed, axis)))
+                visit(node, &visited, &order);
+        }
+    }
+
+    QPointer<QWidget> changedGuard(changed);
+    QVector<QPointer<DAnchorsBase>> guards;
+    guards.reserve(order.size());
+    for (const Node &node : order) {
+        guards << node.first->q_ptr;
+
+        if (node.first->extendWidget)
+            solvingWidgets << node.first->extendWidget->target();
+    }
+
+    QSet<const QWidget *> changedWidgets;
+    if (changed) {
+        changedWidgets << changed;
+        solvingWidgets << changed;
+    }
+
+    // 按拓扑序更新，每个节点至多计算一次；输入没有变化的节点跳过。
+    // 期间产生的几何变化信号已包含在这次求解中，不再触发更新
+    solving = true;
+    for (int i = order.size() - 1; i >= 0; --i) {
+        if (!guards.at(i))
+            continue;
+
+        DAnchorsBasePrivate *d = order.at(i).first;
+        const int kind = order.at(i).second;
+        QWidget *w = d->extendWidget->target();
+
+        bool inputChanged = roots.contains(order.at(i))
+                || (d->dependsOnOwnSize(kind) && changedWidgets.contains(w));
+
+        for (const QWidget *input : d->inputWidgets(kind)) {
+            if (inputChanged)
+                break;
+
+            inputChanged = changedWidgets.contains(input);
+        }
+
+        if (!inputChanged || !w)
+            continue;
+
+        const QRect geometry = w->geometry();
+        d->applyUpdate(kind);
+
+        if (w->geometry() != geometry)
+            changedWidgets << w;
+    }
+    solving = false;
+    solvingWidgets.clear();
+
+    if (changedGuard) {
+        lastChangedWidget = changedGuard;
+        lastChangedGeometry = changedGuard->geometry();
+    }
+}
+
+void DAnchorsBasePrivate::runPendingUpdates()
+{
+    while (!pendingUpdates.isEmpty()) {
+        const PendingUpdate pending = pendingUpdates.takeFirst();
+
+        if (pending.base) {
+            DAnchorsBasePrivate *d = pending.base->d_func();
+            QVector<Node> roots;
+
+            for (int kind : { VerticalUpdate, HorizontalUpdate, RectUpdate }) {
+                if (pending.kinds & kind)
+                    roots << Node(d, kind);
+            }
+
+            solve(nullptr, roots);
+        } else if (QWidget *changed = pending.changed) {
+            // 一次几何变化会依次发出多个信号，只需要求解一次
+            if (changed == lastChangedWidget && changed->geometry() == lastChangedGeometry)
+                continue;
+
+            solve(changed, {});
+        }
+    }
+}
+
+// 锚定设置变化时，更新自身并按拓扑序更新依赖它的控件
+void DAnchorsBasePrivate::update(int kinds)
+{
+    pendingUpdates << PendingUpdate { nullptr, q_ptr, kinds };
+
+    if (!solving)
+        runPendingUpdates();
+}
+
+void DAnchorsBasePrivate::geometryChanged(const DEnhancedWidget *sender, UpdateKind kind)
+{
+    QWidget *changed = sender ? sender->target() : nullptr;
+
+    if (!changed) {
+        update(kind);
+        return;
+    }
+
+    if (solving && solvingWidgets.contains(changed))
+        return;
+
+    pendingUpdates << PendingUpdate { changed, nullptr, kind };
+
+    if (!solving)
+        runPendingUpdates();
+}
+
+void DAnchorsBase::updateVertical()
+{
+    Q_D(DAnchorsBase);
+
+    d->geometryChanged(qobject_cast<DEnhancedWidget *>(sender()), DAnchorsBasePrivate::VerticalUpdate);
+}
+
+void DAnchorsBase::updateHorizontal()
+{
+    Q_D(DAnchorsBase);
+
+    d->geometryChanged(qobject_cast<DEnhancedWidget *>(sender()), DAnchorsBasePrivate::HorizontalUpdate);
+}
+
+void DAnchorsBase::updateFill()
+{
+    Q_D(DAnchorsBase);
+
+    d->geometryChanged(qobject_cast<DEnhancedWidget *>(sender()), DAnchorsBasePrivate::RectUpdate);
 }
 
 void DAnchorsBase::updateCenterIn()
 {
     Q_D(DAnchorsBase);
 
-    QRect rect = d->getWidgetRect(d->centerIn->target());
-    moveCenter(rect.center());
+    d->geometryChanged(qobject_cast<DEnhancedWidget *>(sender()), DAnchorsBasePrivate::RectUpdate);
 }
 
 void DAnchorsBase::init(QWidget *w)
@@ -396,11 +396,52 @@ void DApplicationPrivate::_q_sizeModeChanged()
     }
 }
 
+void DApplicationPrivate::addPendingSizeModeWidget(QWidget *widget)
+{
+    if (pendingSizeModeWidgets.contains(widget))
+        return;
+
+    D_Q(DApplication);
+    pendingSizeModeWidgets.insert(widget, QObject::connect(widget, &QObject::destroyed, q, [this, widget] {
+        pendingSizeModeWidgets.remove(widget);
+    }));
+}
+
+bool DApplicationPrivate::takePendingSizeModeWidget(QWidget *widget)
+{
+    auto it = pendingSizeModeWidgets.find(widget);
+    if (it == pendingSizeModeWidgets.end())
+        return false;
+
+    QObject::disconnect(it.value());
+    pendingSizeModeWidgets.erase(it);
+    return true;
+}
+
+void DApplicationPrivate::handlePendingSizeModeChange(QWidget *widget)
+{
+    if (!takePendingSizeModeWidget(widget))
+        return;
+
+    QEvent ev(QEvent::StyleChange);
+    handleSizeModeChangeEvent(widget, &ev);
+}
+
 void DApplicationPrivate::handleSizeModeChangeEvent(QWidget *widget, QEvent *event)
 {
+    // 不可见的控件（及其子控件）推迟到再次显示时再处理，控件数量很多时，
+    // 避免一次性给所有控件发送事件导致界面卡顿
+    if (!widget->isVisible()) {
+        addPendingSizeModeWidget(widget);
+        return;
+    }
+
+    takePendingSizeModeWidget(widget);
+
     // 深度优先遍历，事件接受顺序：子 -> 父， 若parentWidget先处理event，可能存在布局没更新问题
-    for (auto w : widget->findChildren<QWidget *>(QString(), Qt::FindDirectChildrenOnly)) {
-        handleSizeModeChangeEvent(w, event);
+    for (auto child : widget->children()) {
+        if (child->isWidgetType())
+            handleSizeModeChangeEvent(static_cast<QWidget *>(child), event);
     }
     if (widget->isWindow()) {
         // TODO 顶层窗口需要延迟，否则内部控件布局出现异常，例如DDialog, 若send事件，导致
@@ -1539,6 +1580,13 @@ bool DApplication::notify(QObject *obj, QEvent *event)
         }
     }
 
+    if (event->type() == QEvent::Show && obj->isWidgetType()) {
+        D_D(DApplication);
+        // 尺寸模式变化时处于隐藏状态的控件，在显示前补发更新
+        if (!d->pendingSizeModeWidgets.isEmpty())
+            d->handlePendingSizeModeChange(static_cast<QWidget *>(obj));
+    }
+
     if (event->type() == QEvent::ApplicationFontChange) {
         // ApplicationFontChange 调用 font() 是 ok 的，如果在 fontChanged 中调用在某些版本中会出现 deadlock
         DFontSizeManager::instance()->setFontGenericPixelSize(static_cast<quint16>(DFontSizeManager::fontPixelSize(font())));
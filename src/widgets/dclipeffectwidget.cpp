@@ -22,6 +22,7 @@ public:
     DClipEffectWidgetPrivate(DClipEffectWidget *qq);
 
     void updateImage();
+    bool needCapture(const QRect &dirtyRect) const;
 
     QImage image;
     QRectF imageGeometry;
@@ -39,6 +40,16 @@ DClipEffectWidgetPrivate::DClipEffectWidgetPrivate(DClipEffectWidget *qq)
 
 }
 
+// 脏区域完全位于 clipPath 内部时，没有任何内容会被裁剪，无需截取窗口内容
+bool DClipEffectWidgetPrivate::needCapture(const QRect &dirtyRect) const
+{
+    if (dirtyRect.isEmpty())
+        return false;
+
+    // 向外扩展一个像素，覆盖 clipPath 边缘抗锯齿的部分
+    return !path.contains(QRectF(dirtyRect).adjusted(-1, -1, 1, 1));
+}
+
 /*!
   \class Dtk::Widget::DClipEffectWidget
   \inmodule dtkwidget
@@ -185,30 +196,42 @@ bool DClipEffectWidget::eventFilter(QObject *watched, QEvent *event)
         return false;
 
     if (event->type() == QEvent::Paint) {
+        QPaintEvent *e = static_cast<QPaintEvent*>(event);
+        // 此控件位置一直为 0,0，且大小和父控件一致，所以父控件的脏区域可直接用于此控件
+        const QRect &dirtyRect = e->rect() & rect().marginsRemoved(d->margins);
+
+        if (!d->needCapture(dirtyRect))
+            return false;
+
+        // offset也是父控件相对于顶级窗口的偏移
         const QPoint &offset = mapTo(window(), QPoint(0, 0));
         const QImage &image = window()->backingStore()->handle()->toImage();
         qreal scale = devicePixelRatioF();
 
         d->imageGeometry = QRectF(image.rect()) & multiply(QRect(offset, size()), scale);
 
-        if (d->image.isNull() || d->imageGeometry.size() != d->image.size()) {
-            d->image = image.copy(d->imageGeometry.toRect());
-            d->image.setDevicePixelRatio(scale);
-        } else {
-            QPaintEvent *e = static_cast<QPaintEvent*>(event);
-            QPainter p;
-            // 此控件位置一直为 0,0，且大小和父控件一致，所以offset也是父控件相对于顶级窗口的偏移
-            const QRectF &rect = QRectF(image.rect()) & multiply(e->rect().translated(offset), scale);
+        // 复用缓存图片，只在大小变化时重新分配。paintEvent 只会绘制本次父控件的
+        // 脏区域，因此只需要更新这部分内容
+        const QSize &imageSize = d->imageGeometry.toRect().size();
+        if (d->image.size() != imageSize || d->image.format() != image.format()) {
+            d->image = QImage(imageSize, image.format());
+        }
 
-            d->image.setDevicePixelRatio(image.devicePixelRatio());
+        const QRectF &sourceRect = QRectF(image.rect()) & multiply(dirtyRect.translated(offset), scale);
 
-            p.begin(&d->image);
-            p.setCompositionMode(QPainter::CompositionMode_Source);
-            p.drawImage(rect.topLeft() - d->imageGeometry.topLeft(), image.copy(rect.toRect()));
-            p.end();
+        if (sourceRect.isEmpty())
+            return false;
 
-            d->image.setDevicePixelRatio(scale);
-        }
+        QPainter p;
+
+        d->image.setDevicePixelRatio(image.devicePixelRatio());
+
+        p.begin(&d->image);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.drawImage(sourceRect.topLeft() - d->imageGeometry.topLeft(), image, sourceRect);
+        p.end();
+
+        d->image.setDevicePixelRatio(scale);
     } else if (event->type() == QEvent::Resize) {
         resize(parentWidget()->size());
     }
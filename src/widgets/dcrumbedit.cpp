@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "dcrumbedit.h"
+#include "private/dcrumbedit_p.h"
 #include "dobject_p.h"
 #include "DStyle"
 #include "dsizemode.h"
@@ -10,6 +11,7 @@
 #include <QAbstractTextDocumentLayout>
 #include <QPainter>
 #include <QPainterPath>
+#include <QStaticText>
 #include <QTextBlock>
 #include <QStyleOptionFrame>
 #include <QMouseEvent>
@@ -86,32 +88,6 @@ QBrush static getGradientBrush(Background background)
     return QBrush(lg);
 }
 
-class CrumbObjectInterface : public QObject, public QTextObjectInterface
-{
-    Q_OBJECT
-    Q_INTERFACES(QTextObjectInterface)
-
-public:
-    enum TextMargin
-    {
-        TopMargin = 2,
-        LeftMargin = 4,
-    };
-
-    explicit CrumbObjectInterface(QObject *parent = nullptr)
-        : QObject(parent)
-    {
-    }
-
-    QSizeF intrinsicSize(QTextDocument *doc, int posInDocument,
-                         const QTextFormat &format) Q_DECL_OVERRIDE;
-
-    void drawObject(QPainter *painter, const QRectF &rect, QTextDocument *doc,
-                    int posInDocument, const QTextFormat &format) Q_DECL_OVERRIDE;
-
-    QBrush backgroundBrush(const QRect &rect, const QBrush &brush);
-};
-
 class DCrumbEditPanelFrame : public QWidget {
     Q_OBJECT
 
@@ -486,36 +462,35 @@ public:
 
         bool formatsChanged = false;
 
-        QTextCursor cursor(q->document());
         QSet<QString> crumbList;
-        int last_pos = 0;
 
-        cursor.setPosition(0);
         formatList.clear();
 
-        while (!cursor.atEnd()) {
-            cursor.setPosition(last_pos + 1);
-
-            if (last_pos == cursor.position())
-                break;
-
-            last_pos = cursor.position();
+        // 按 fragment 遍历，每个 crumb 只访问一次
+        for (QTextBlock block = q->document()->begin(); block.isValid(); block = block.next()) {
+            for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+                const QTextFragment &fragment = it.fragment();
 
-            DCrumbTextFormat format(cursor.charFormat());
+                if (fragment.charFormat().objectType() != objectType)
+                    continue;
 
-            if (format.objectType() == objectType) {
+                DCrumbTextFormat format(fragment.charFormat());
                 const QString &text = format.text();
 
-                if (!text.isEmpty()) {
+                if (text.isEmpty())
+                    continue;
+
+                // 相同格式的相邻 crumb 会合并为一个 fragment
+                for (int i = 0; i < fragment.length(); ++i) {
                     crumbList << text;
                     formatList << text;
+                }
 
-                    if (!formats.contains(text)) {
-                        formats[text] = format;
-                        formatsChanged = true;
+                if (!formats.contains(text)) {
+                    formats[text] = format;
+                    formatsChanged = true;
 
-                        Q_EMIT q->crumbAdded(text);
-                    }
+                    Q_EMIT q->crumbAdded(text);
                 }
             }
         }
@@ -554,19 +529,45 @@ public:
     QWidget* widgetRight;
 };
 
+CrumbObjectInterface::CrumbGeometry &CrumbObjectInterface::geometry(const DCrumbTextFormat &format, const QFont &font)
+{
+    const int radius = format.backgroundRadius();
+    const bool hasTag = format.tagColor().isValid();
+    const QString &key = QStringLiteral("%1\x1f%2\x1f%3").arg(font.key(), QString::number(radius), format.text())
+            + (hasTag ? QLatin1Char('t') : QLatin1Char('n'));
+
+    auto it = geometries.find(key);
+    if (it != geometries.end())
+        return it.value();
+
+    // 已删除的 crumb 不会再用到，数量过多时整体丢弃
+    if (geometries.size() >= 16384)
+        geometries.clear();
+
+    const QFontMetricsF font_metrics(font);
+    CrumbGeometry geometry;
+
+    geometry.fontHeight = font_metrics.height();
+    geometry.text.setTextFormat(Qt::PlainText);
+    geometry.text.setText(format.text());
+    geometry.text.prepare(QTransform(), font);
+
+    if (hasTag)
+        geometry.size = QSizeF(font_metrics.horizontalAdvance(format.text()) + font_metrics.height() + radius + 2, font_metrics.height() + 2);
+    else
+        geometry.size = QSizeF(font_metrics.horizontalAdvance(format.text()) + 2 * radius + 2, font_metrics.height() + 2 + TopMargin *2);
+
+    return geometries.insert(key, geometry).value();
+}
+
 QSizeF CrumbObjectInterface::intrinsicSize(QTextDocument *doc, int posInDocument, const QTextFormat &format)
 {
     Q_UNUSED(doc)
     Q_UNUSED(posInDocument)
 
     const DCrumbTextFormat crumb_format(format);
-    const QFontMetricsF font_metrics(crumb_format.font());
-    int radius = crumb_format.backgroundRadius();
 
-    if (crumb_format.tagColor().isValid())
-        return QSizeF(font_metrics.horizontalAdvance(crumb_format.text()) + font_metrics.height() + radius + 2, font_metrics.height() + 2);
-
-    return QSizeF(font_metrics.horizontalAdvance(crumb_format.text()) + 2 * radius + 2, font_metrics.height() + 2 + TopMargin *2);
+    return geometry(crumb_format, crumb_format.font()).size;
 }
 
 void CrumbObjectInterface::drawObject(QPainter *painter, const QRectF &rect,
@@ -577,29 +578,42 @@ void CrumbObjectInterface::drawObject(QPainter *painter, const QRectF &rect,
 
     const QRect new_rect = rect.adjusted(LeftMargin, TopMargin, 0, -TopMargin).toRect();
     const DCrumbTextFormat crumb_format(format);
-    const QFontMetricsF font_metrics(crumb_format.font());
+    const QFont &font = crumb_format.font();
     const int radius = crumb_format.backgroundRadius();
+    CrumbGeometry &geometry = this->geometry(crumb_format, font);
+
+    // 路径和文本位置相对于 crumb 左上角，只依赖 crumb 的大小
+    if (geometry.rectSize != new_rect.size()) {
+        const QRect local_rect(QPoint(0, 0), new_rect.size());
+        const QRectF tag_rect(2, 2, geometry.fontHeight - 4, geometry.fontHeight - 4);
+        const QSizeF &text_size = geometry.text.size();
+
+        geometry.rectSize = new_rect.size();
+        geometry.tagPath = QPainterPath();
+        geometry.tagPath.addEllipse(tag_rect);
+        geometry.backgroundPath = QPainterPath();
+        geometry.backgroundPath.addRoundedRect(local_rect, radius, radius);
+
+        if (crumb_format.tagColor().isValid()) {
+            const QRectF text_rect = QRectF(local_rect).adjusted(tag_rect.width() + 2, 0, -radius, 0);
+            geometry.textPos = QPointF(text_rect.right() - text_size.width(), (text_rect.height() - text_size.height()) / 2);
+        } else {
+            geometry.textPos = QPointF((local_rect.width() - text_size.width()) / 2, (local_rect.height() - text_size.height()) / 2);
+        }
+    }
 
-    QPainterPath background_path;
-    QPainterPath tag_path;
-    const QRectF tag_rect(new_rect.x() + 2, new_rect.y() + 2, font_metrics.height() - 4, font_metrics.height() - 4);
-
-    tag_path.addEllipse(tag_rect);
-    background_path.addRoundedRect(new_rect, radius, crumb_format.backgroundRadius());
-
+    painter->save();
     painter->setRenderHint(QPainter::Antialiasing);
-    painter->fillPath(background_path, backgroundBrush(new_rect, crumb_format.background()));
+    painter->translate(new_rect.topLeft());
+    painter->fillPath(geometry.backgroundPath, backgroundBrush(QRect(QPoint(0, 0), new_rect.size()), crumb_format.background()));
 
-    if (crumb_format.tagColor().isValid()) {
-        painter->fillPath(tag_path, crumb_format.tagColor());
+    if (crumb_format.tagColor().isValid())
+        painter->fillPath(geometry.tagPath, crumb_format.tagColor());
 
-        painter->setPen(crumb_format.textColor());
-        painter->drawText(new_rect.adjusted(tag_rect.width() + 2, 0, -radius, 0),
-                          crumb_format.text(), Qt::AlignVCenter | Qt::AlignRight);
-    } else {
-        painter->setPen(crumb_format.textColor());
-        painter->drawText(new_rect, Qt::AlignCenter, crumb_format.text());
-    }
+    painter->setFont(font);
+    painter->setPen(crumb_format.textColor());
+    painter->drawStaticText(geometry.textPos, geometry.text);
+    painter->restore();
 }
 
 QBrush CrumbObjectInterface::backgroundBrush(const QRect &rect, const QBrush &brush)
@@ -997,7 +1011,7 @@ bool DCrumbEdit::event(QEvent *e)
     } else if (e->type() == QEvent::StyleChange)  {
         int frameRadius = DStyle::pixelMetric(style(), DStyle::PM_FrameRadius);
         // update crumbRadius if not set.
-        if (!d->explicitCrumbRadius) {
+        if (!d->explicitCrumbRadius && d->crumbRadius != frameRadius) {
         d->crumbRadius = frameRadius;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         auto collection = document()->docHandle()->formatCollection();
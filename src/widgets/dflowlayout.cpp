@@ -39,60 +39,76 @@ QSize DFlowLayoutPrivate::doLayout(const QRect &rect, bool testOnly) const
 
     QSize size_hint;
 
+    // sizeHint() 的计算代价可能较高（例如包含文本的控件），每个元素在一次布局中只获取一次
+    QVector<QSize> itemSizes;
+    itemSizes.reserve(itemList.size());
+    for (QLayoutItem *item : itemList)
+        itemSizes.append(item->isEmpty() ? QSize() : item->sizeHint());
+
+    // 只移动位置发生变化的元素，通常只有第一个发生变化的行之后的元素需要重新设置
+    auto setItemGeometry = [](QLayoutItem *item, const QRect &geometry) {
+        if (item->geometry() != geometry)
+            item->setGeometry(geometry);
+    };
+
     if(flow == DFlowLayout::Flow::LeftToRight) {
         int maxWidth = 0;
         int lineHeight = 0;
 
         if(q->parentWidget()->layoutDirection() == Qt::RightToLeft) {
-            for (QLayoutItem *item : itemList) {
+            for (int i = 0; i < itemList.size(); ++i) {
+                QLayoutItem *item = itemList.at(i);
                 if (item->isEmpty())
                     continue;
+                const QSize &itemSize = itemSizes.at(i);
                 // QRect's x2 = x1 + width - 1
-                int nextX = x - item->sizeHint().width() - horizontalSpacing + 1;
+                int nextX = x - itemSize.width() - horizontalSpacing + 1;
 
                 if (nextX + horizontalSpacing < effectiveRect.x() && lineHeight > 0) {
                     x = effectiveRect.right();
                     y = y + lineHeight + verticalSpacing;
-                    nextX = x - item->sizeHint().width() - horizontalSpacing + 1;
+                    nextX = x - itemSize.width() - horizontalSpacing + 1;
                     lineHeight = 0;
                 }
 
                 if (!testOnly) {
                     QRect item_geometry;
 
-                    item_geometry.setSize(item->sizeHint());
+                    item_geometry.setSize(itemSize);
                     item_geometry.moveTopRight(QPoint(x, y));
-                    item->setGeometry(item_geometry);
+                    setItemGeometry(item, item_geometry);
                 }
 
                 x = nextX;
                 // QRect's width = x2 - x1 + 1
                 maxWidth = qMax(effectiveRect.right() - nextX - horizontalSpacing + 1, maxWidth);
-                lineHeight = qMax(lineHeight, item->sizeHint().height());
+                lineHeight = qMax(lineHeight, itemSize.height());
             }
 
             size_hint = QSize(maxWidth, y + lineHeight - rect.y() + bottom);
         } else {
-            for (QLayoutItem *item : itemList) {
+            for (int i = 0; i < itemList.size(); ++i) {
+                QLayoutItem *item = itemList.at(i);
                 if (item->isEmpty())
                     continue;
+                const QSize &itemSize = itemSizes.at(i);
                 // QRect's x2 = x1 + width - 1
-                int nextX = x + item->sizeHint().width() + horizontalSpacing - 1;
+                int nextX = x + itemSize.width() + horizontalSpacing - 1;
 
                 if (nextX - horizontalSpacing > effectiveRect.right() && lineHeight > 0) {
                     x = effectiveRect.x();
                     y = y + lineHeight + verticalSpacing;
-                    nextX = x + item->sizeHint().width() + horizontalSpacing - 1;
+                    nextX = x + itemSize.width() + horizontalSpacing - 1;
                     lineHeight = 0;
                 }
 
                 if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x, y), item->sizeHint()));
+                    setItemGeometry(item, QRect(QPoint(x, y), itemSize));
 
                 x = nextX;
                 // QRect's width = x2 - x1 + 1
                 maxWidth = qMax(nextX - effectiveRect.x() - horizontalSpacing + 1, maxWidth);
-                lineHeight = qMax(lineHeight, item->sizeHint().height());
+                lineHeight = qMax(lineHeight, itemSize.height());
             }
 
             size_hint = QSize(maxWidth, y + lineHeight - rect.y() + bottom);
@@ -102,50 +118,54 @@ QSize DFlowLayoutPrivate::doLayout(const QRect &rect, bool testOnly) const
         int lineWidth = 0;
 
         if(q->parentWidget()->layoutDirection() == Qt::RightToLeft) {
-            for (QLayoutItem *item : itemList) {
+            for (int i = 0; i < itemList.size(); ++i) {
+                QLayoutItem *item = itemList.at(i);
                 if (item->isEmpty())
                     continue;
+                const QSize &itemSize = itemSizes.at(i);
                 // QRect's y2 = y1 + height - 1
-                int nextY = y + item->sizeHint().height() + verticalSpacing - 1;
+                int nextY = y + itemSize.height() + verticalSpacing - 1;
 
                 if(nextY - verticalSpacing > effectiveRect.bottom() && lineWidth > 0) {
                     y = effectiveRect.y();
                     x = x - lineWidth - horizontalSpacing;
-                    nextY = y + item->sizeHint().height() + verticalSpacing - 1;
+                    nextY = y + itemSize.height() + verticalSpacing - 1;
                     lineWidth = 0;
                 }
 
                 if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x - item->sizeHint().width(), y), item->sizeHint()));
+                    setItemGeometry(item, QRect(QPoint(x - itemSize.width(), y), itemSize));
 
                 y = nextY;
                 // height = y2 - y1 + 1
                 maxHeight = qMax(nextY - effectiveRect.y() - verticalSpacing + 1, maxHeight);
-                lineWidth = qMax(lineWidth, item->sizeHint().width());
+                lineWidth = qMax(lineWidth, itemSize.width());
             }
 
             size_hint = QSize(rect.right() - x + lineWidth + right + 1, maxHeight);
         } else {
-            for (QLayoutItem *item : itemList) {
+            for (int i = 0; i < itemList.size(); ++i) {
+                QLayoutItem *item = itemList.at(i);
                 if (item->isEmpty())
                     continue;
+                const QSize &itemSize = itemSizes.at(i);
                 // QRect's x2 = x1 + width - 1
-                int nextY = y + item->sizeHint().height() + verticalSpacing - 1;
+                int nextY = y + itemSize.height() + verticalSpacing - 1;
 
                 if(nextY - verticalSpacing > effectiveRect.bottom() && lineWidth > 0) {
                     y = effectiveRect.y();
                     x = x + lineWidth + horizontalSpacing;
-                    nextY = y + item->sizeHint().height() + verticalSpacing - 1;
+                    nextY = y + itemSize.height() + verticalSpacing - 1;
                     lineWidth = 0;
                 }
 
                 if (!testOnly)
-                    item->setGeometry(QRect(QPoint(x, y), item->sizeHint()));
+                    setItemGeometry(item, QRect(QPoint(x, y), itemSize));
 
                 y = nextY;
                 // height = y2 - y1 + 1
                 maxHeight = qMax(nextY - effectiveRect.y() - verticalSpacing + 1, maxHeight);
-                lineWidth = qMax(lineWidth, item->sizeHint().width());
+                lineWidth = qMax(lineWidth, itemSize.width());
             }
 
             size_hint = QSize(x + lineWidth - rect.x() + right, maxHeight);
@@ -213,6 +233,7 @@ DFlowLayout::~DFlowLayout()
 void DFlowLayout::insertItem(int index, QLayoutItem *item)
 {
     d_func()->itemList.insert(index, item);
+    d_func()->hfwWidth = -1;
 
     Q_EMIT countChanged(count());
 }
@@ -395,7 +416,13 @@ int DFlowLayout::heightForWidth(int width) const
         return d->sizeHint.height();
     }
 
-    return d->doLayout(QRect(0, 0, width, 0), true).height();
+    // 调整窗口大小时 Qt 会以同一宽度多次调用此函数，缓存上次的计算结果
+    if (width != d->hfwWidth) {
+        d->hfwHeight = d->doLayout(QRect(0, 0, width, 0), true).height();
+        d->hfwWidth = width;
+    }
+
+    return d->hfwHeight;
 }
 
 /*!
@@ -429,6 +456,16 @@ QSize DFlowLayout::minimumSize() const
     return size;
 }
 
+/*
+  \reimp
+ */
+void DFlowLayout::invalidate()
+{
+    d_func()->hfwWidth = -1;
+
+    QLayout::invalidate();
+}
+
 /*
   \reimp
  */
@@ -462,6 +499,7 @@ QLayoutItem *DFlowLayout::takeAt(int index)
     }
 
     QLayoutItem *item = d->itemList.takeAt(index);
+    d->hfwWidth = -1;
 
     if (QLayout *l = item->layout()) {
         // sanity check in case the user passed something weird to QObject::setParent()
@@ -4,12 +4,42 @@
 
 #include "dgraphicsgloweffect.h"
 
+#include <QHash>
+
 QT_BEGIN_NAMESPACE
 extern Q_WIDGETS_EXPORT void qt_blurImage(QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0);
 QT_END_NAMESPACE
 
 DWIDGET_BEGIN_NAMESPACE
 
+// 头文件中的成员布局需要保持二进制兼容，发散效果的缓存保存在这里
+struct GlowCache
+{
+    QPixmap source;
+    qreal blurRadius = 0;
+    qreal distance = 0;
+    QColor color;
+    QImage glow;
+
+    bool matches(const QPixmap &pixmap, qreal radius, qreal dist, const QColor &c) const
+    {
+        if (glow.isNull() || !qFuzzyCompare(blurRadius, radius) || !qFuzzyCompare(distance, dist) || color != c)
+            return false;
+
+        if (source.size() != pixmap.size() || !qFuzzyCompare(source.devicePixelRatio(), pixmap.devicePixelRatio()))
+            return false;
+
+        // QGraphicsItem 的 source 会复用缓存的 pixmap，控件每次都会重新绘制，此时比较内容
+        return source.cacheKey() == pixmap.cacheKey() || source.toImage() == pixmap.toImage();
+    }
+};
+
+static QHash<const DGraphicsGlowEffect *, GlowCache> &glowCaches()
+{
+    static QHash<const DGraphicsGlowEffect *, GlowCache> caches;
+    return caches;
+}
+
 /*!
   \class Dtk::Widget::DGraphicsGlowEffect
   \inmodule dtkwidget
@@ -32,6 +62,9 @@ DGraphicsGlowEffect::DGraphicsGlowEffect(QObject *parent) :
     m_blurRadius(10.0),
     m_color(0, 0, 0, 80)
 {
+    connect(this, &QObject::destroyed, [this] {
+        glowCaches().remove(this);
+    });
 }
 
 /*!
@@ -57,6 +90,45 @@ void DGraphicsGlowEffect::draw(QPainter *painter)
         return;
     }
 
+    // 只在内容或参数变化时重新模糊，移动和透明度变化直接使用缓存
+    GlowCache &cache = glowCaches()[this];
+    if (!cache.matches(sourcePx, blurRadius(), distance(), color())) {
+        // Calculate size for the background image
+        QSize scaleSize(sourcePx.size().width() + 2 * distance(),
+                        sourcePx.size().height() + 2 * distance());
+
+        QImage tmpImg(scaleSize, QImage::Format_ARGB32_Premultiplied);
+        QPixmap scaled = sourcePx.scaled(scaleSize);
+        tmpImg.fill(0);
+        QPainter tmpPainter(&tmpImg);
+        tmpPainter.setCompositionMode(QPainter::CompositionMode_Source);
+        tmpPainter.drawPixmap(QPointF(-distance(), -distance()), scaled);
+        tmpPainter.end();
+
+        // blur the alpha channel
+        QImage blurred(tmpImg.size(), QImage::Format_ARGB32_Premultiplied);
+        blurred.fill(0);
+        QPainter blurPainter(&blurred);
+        qt_blurImage(&blurPainter, tmpImg, blurRadius(), false, true);
+        blurPainter.end();
+
+        tmpImg = blurred;
+
+        // blacken the image...
+        tmpPainter.begin(&tmpImg);
+        tmpPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        tmpPainter.fillRect(tmpImg.rect(), color());
+        tmpPainter.end();
+
+        cache.source = sourcePx;
+        cache.blurRadius = blurRadius();
+        cache.distance = distance();
+        cache.color = color();
+        cache.glow = tmpImg;
+    } else if (cache.source.cacheKey() != sourcePx.cacheKey()) {
+        cache.source = sourcePx;
+    }
+
     qreal restoreOpacity = painter->opacity();
     painter->setOpacity(m_opacity);
 
@@ -64,35 +136,8 @@ void DGraphicsGlowEffect::draw(QPainter *painter)
     QTransform restoreTransform = painter->worldTransform();
     painter->setWorldTransform(QTransform());
 
-    // Calculate size for the background image
-    QSize scaleSize(sourcePx.size().width() + 2 * distance(),
-                    sourcePx.size().height() + 2 * distance());
-
-    QImage tmpImg(scaleSize, QImage::Format_ARGB32_Premultiplied);
-    QPixmap scaled = sourcePx.scaled(scaleSize);
-    tmpImg.fill(0);
-    QPainter tmpPainter(&tmpImg);
-    tmpPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    tmpPainter.drawPixmap(QPointF(-distance(), -distance()), scaled);
-    tmpPainter.end();
-
-    // blur the alpha channel
-    QImage blurred(tmpImg.size(), QImage::Format_ARGB32_Premultiplied);
-    blurred.fill(0);
-    QPainter blurPainter(&blurred);
-    qt_blurImage(&blurPainter, tmpImg, blurRadius(), false, true);
-    blurPainter.end();
-
-    tmpImg = blurred;
-
-    // blacken the image...
-    tmpPainter.begin(&tmpImg);
-    tmpPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-    tmpPainter.fillRect(tmpImg.rect(), color());
-    tmpPainter.end();
-
     // draw the blurred shadow...
-    painter->drawImage(offset, tmpImg);
+    painter->drawImage(offset, cache.glow);
 
     // draw the actual pixmap...
     painter->drawPixmap(offset, sourcePx, QRectF());
@@ -117,4 +162,19 @@ QRectF DGraphicsGlowEffect::boundingRectFor(const QRectF &rect) const
     return rect.united(rect.adjusted(-delta - xOffset(), -delta - yOffset(), delta - xOffset(), delta - yOffset()));
 }
 
+/*!
+  \brief 源的内容失效时丢弃缓存的发散效果
+  \brief Drops the cached glow when the source content is invalidated.
+
+  \a flags 描述源发生的变化
+  \a flags describes what changed in the source
+ */
+void DGraphicsGlowEffect::sourceChanged(ChangeFlags flags)
+{
+    if (flags & (SourceInvalidated | SourceDetached))
+        glowCaches().remove(this);
+
+    QGraphicsEffect::sourceChanged(flags);
+}
+
 DWIDGET_END_NAMESPACE
@@ -216,15 +216,14 @@ void DLabel::paintEvent(QPaintEvent *event)
                 const bool showToolTip = (toolTipShowMode == DToolTip::AlwaysShow)
                         || ((toolTipShowMode == DToolTip::ShowWhenElided) && (d->text != text));
                 if (DToolTip::needUpdateToolTip(this, showToolTip)) {
-                    QString toolTip;
+                    QTextOption textOption;
                     if (showToolTip) {
-                        QTextOption textOption;
                         textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
                         textOption.setTextDirection(opt.direction);
                         textOption.setAlignment(Qt::Alignment(align));
-                        toolTip = DToolTip::wrapToolTipText(d->text, textOption);
                     }
-                    this->setToolTip(toolTip);
+                    // 只在 ToolTip 真正显示时才换行
+                    DToolTip::setWrappedToolTip(this, showToolTip ? d->text : QString(), textOption);
                     DToolTip::setShowToolTip(this, showToolTip);
                 }
             }
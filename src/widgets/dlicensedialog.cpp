@@ -11,11 +11,12 @@
 #include <DListView>
 #include <DHorizontalLine>
 #include <DLicenseInfo>
+#include <DPlainTextEdit>
 
+#include <QHash>
 #include <QLabel>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
-#include <QScrollArea>
 #include <QScrollBar>
 #include <QStackedLayout>
 
@@ -30,8 +31,10 @@ public:
 
 private:
     void init();
-    void addComponentItem(const DLicenseInfo::DComponentInfo *DComponentInfo);
+    QStandardItem *createComponentItem(const DLicenseInfo::DComponentInfo *componentInfo, int row, const QIcon &enterIcon);
     bool loadLicense();
+    void showComponent(int row);
+    QString licenseContent(const QString &licenseName);
 
     DTitlebar          *titleBar = nullptr;
     DIconButton        *backwardBtn = nullptr;
@@ -41,11 +44,11 @@ private:
     QLabel             *componentNameLabel = nullptr;
     QLabel             *componentVersionLabel = nullptr;
     QLabel             *copyRightLabel = nullptr;
-    QLabel             *licenseContentLabel = nullptr;
-    QScrollArea        *scrollArea = nullptr;
+    DPlainTextEdit     *licenseContentView = nullptr;
     QByteArray         content;
     QString            path;
     DLicenseInfo       licenseInfo;
+    QHash<QString, QString> licenseContentCache;
     bool isValid = false;
 
 private:
@@ -61,8 +64,7 @@ DLicenseDialogPrivate::DLicenseDialogPrivate(DLicenseDialog *qq)
     , componentNameLabel(new QLabel)
     , componentVersionLabel(new QLabel)
     , copyRightLabel(new QLabel)
-    , licenseContentLabel(new QLabel)
-    , scrollArea(new QScrollArea)
+    , licenseContentView(new DPlainTextEdit)
 {
 }
 
@@ -92,7 +94,15 @@ void DLicenseDialogPrivate::init()
     fontManager->bind(componentVersionLabel, DFontSizeManager::T6, QFont::DemiBold);
     fontManager->bind(copyRightLabel, DFontSizeManager::T6, QFont::DemiBold);
 
-    licenseContentLabel->setWordWrap(true);
+    // QPlainTextEdit only lays out the blocks inside the viewport, so even
+    // license texts of several hundred KB are not wrapped in one piece on resize.
+    licenseContentView->setReadOnly(true);
+    licenseContentView->setFrameStyle(QFrame::NoFrame);
+    licenseContentView->setLineWrapMode(QPlainTextEdit::WidgetWidth);
+    licenseContentView->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    licenseContentView->setBackgroundVisible(false);
+    licenseContentView->viewport()->setAutoFillBackground(false);
+    licenseContentView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
     QWidget *licenseWidget = new QWidget;
     QVBoxLayout *licenseLayout = new QVBoxLayout(licenseWidget);
@@ -105,20 +115,11 @@ void DLicenseDialogPrivate::init()
     licenseLayout->addWidget(componentVersionLabel);
     licenseLayout->addWidget(copyRightLabel);
     licenseLayout->addSpacing(40);
-    licenseLayout->addWidget(licenseContentLabel);
-    licenseLayout->addStretch(0);
-
-    scrollArea->setFrameStyle(QFrame::NoFrame);
-    scrollArea->viewport()->setAutoFillBackground(false);
-    scrollArea->setContentsMargins(QMargins(0,0,0,0));
-    scrollArea->viewport()->setContentsMargins(QMargins(0,0,0,0));
-    scrollArea->setWidget(licenseWidget);
-    scrollArea->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    scrollArea->setWidgetResizable(true);
+    licenseLayout->addWidget(licenseContentView, 1);
     licenseWidget->setAutoFillBackground(false);
 
     stackedLayout->addWidget(listView);
-    stackedLayout->addWidget(scrollArea);
+    stackedLayout->addWidget(licenseWidget);
 
     QVBoxLayout *mainLayout = new QVBoxLayout;
     mainLayout->setContentsMargins(10, 0, 10, 0);
@@ -133,39 +134,55 @@ void DLicenseDialogPrivate::init()
         backwardBtn->setVisible(index != 0);
     });
     QObject::connect(backwardBtn, &QAbstractButton::clicked, q, [this]{
-        scrollArea->horizontalScrollBar()->setValue(0);
-        scrollArea->verticalScrollBar()->setValue(0);
+        licenseContentView->horizontalScrollBar()->setValue(0);
+        licenseContentView->verticalScrollBar()->setValue(0);
         stackedLayout->setCurrentIndex(0);
     });
     QObject::connect(listView, &QAbstractItemView::clicked, q, [this](const QModelIndex &index) {
-        const auto &components = licenseInfo.componentInfos();
-        if (components.size() <= index.row() || index.row() < 0)
-            return;
+        showComponent(index.row());
+    });
+}
 
-        auto componentInfo = components.at(index.row());
+void DLicenseDialogPrivate::showComponent(int row)
+{
+    const auto &components = licenseInfo.componentInfos();
+    if (components.size() <= row || row < 0)
+        return;
 
-        componentNameLabel->setText(componentInfo->name());
-        componentVersionLabel->setText(componentInfo->version());
-        copyRightLabel->setText(componentInfo->copyRight());
-        licenseContentLabel->setText(licenseInfo.licenseContent(componentInfo->licenseName()));
-        stackedLayout->setCurrentIndex(1);
-    });
+    auto componentInfo = components.at(row);
+
+    componentNameLabel->setText(componentInfo->name());
+    componentVersionLabel->setText(componentInfo->version());
+    copyRightLabel->setText(componentInfo->copyRight());
+    licenseContentView->setPlainText(licenseContent(componentInfo->licenseName()));
+    stackedLayout->setCurrentIndex(1);
 }
 
-void DLicenseDialogPrivate::addComponentItem(const DLicenseInfo::DComponentInfo *componentInfo)
+QString DLicenseDialogPrivate::licenseContent(const QString &licenseName)
+{
+    // many components share the same license, only read each license text once,
+    // and only when a component using it is opened for the first time.
+    auto it = licenseContentCache.constFind(licenseName);
+    if (it != licenseContentCache.constEnd())
+        return it.value();
+
+    const QString &text = licenseInfo.licenseContent(licenseName);
+    licenseContentCache.insert(licenseName, text);
+    return text;
+}
+
+QStandardItem *DLicenseDialogPrivate::createComponentItem(const DLicenseInfo::DComponentInfo *componentInfo, int row, const QIcon &enterIcon)
 {
-    D_Q(DLicenseDialog);
     auto pItem = new DStandardItem(componentInfo->name());
     pItem->setEditable(false);
     QSize size(12, 12);
     DViewItemAction *enterAction = new DViewItemAction(Qt::AlignVCenter, size, size, true);
-    enterAction->setIcon(DStyle::standardIcon(q->style(), DStyle::SP_ArrowEnter));
+    enterAction->setIcon(enterIcon);
     pItem->setActionList(Qt::RightEdge, DViewItemActionList() << enterAction);
-    listModel->appendRow(pItem);
-    const auto index  = pItem->index();
-    QObject::connect(enterAction, &DViewItemAction::triggered, enterAction, [this, index] {
-        Q_EMIT listView->clicked(index);
+    QObject::connect(enterAction, &DViewItemAction::triggered, enterAction, [this, row] {
+        Q_EMIT listView->clicked(listModel->index(row, 0));
     });
+    return pItem;
 }
 
 bool DLicenseDialogPrivate::loadLicense()
@@ -175,11 +192,20 @@ bool DLicenseDialogPrivate::loadLicense()
     } else if (!path.isEmpty()) {
         isValid = licenseInfo.loadFile(path);
     }
+    licenseContentCache.clear();
     if (isValid) {
+        D_Q(DLicenseDialog);
         listModel->clear();
-        for (auto component : licenseInfo.componentInfos()) {
-            addComponentItem(component);
+        // the enter arrow is the same for every row, resolve it only once.
+        const QIcon &enterIcon = DStyle::standardIcon(q->style(), DStyle::SP_ArrowEnter);
+        const auto &components = licenseInfo.componentInfos();
+        QList<QStandardItem *> items;
+        items.reserve(components.size());
+        for (int row = 0; row < components.size(); ++row) {
+            items << createComponentItem(components.at(row), row, enterIcon);
         }
+        // insert all rows at once instead of relayouting the view for each component.
+        listModel->appendColumn(items);
     }
     return isValid;
 }
@@ -230,8 +256,8 @@ void DLicenseDialog::hideEvent(QHideEvent *)
     D_D(DLicenseDialog);
     d->backwardBtn->setVisible(false);
     d->stackedLayout->setCurrentIndex(0);
-    d->scrollArea->horizontalScrollBar()->setValue(0);
-    d->scrollArea->verticalScrollBar()->setValue(0);
+    d->licenseContentView->horizontalScrollBar()->setValue(0);
+    d->licenseContentView->verticalScrollBar()->setValue(0);
 }
 DWIDGET_END_NAMESPACE
 #include "moc_dlicensedialog.cpp"
@@ -48,6 +48,11 @@ void DLoadingIndicatorPrivate::setLoadingItem(QGraphicsItem *item)
     item->setPos((q->width()-itemSize.width())/2,
                  (q->height()-itemSize.height())/2);
     item->setTransformOriginPoint(itemSize.width()/2, itemSize.height()/2);
+    // rotating a widget source would render the embedded widget again for every
+    // animation frame, rotate a cached rendering of it instead. The cache is
+    // invalidated whenever the embedded widget repaints itself.
+    if (item->isWidget())
+        item->setCacheMode(QGraphicsItem::ItemCoordinateCache);
 
     q->scene()->clear();
     q->scene()->addItem(item);
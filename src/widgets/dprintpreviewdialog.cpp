@@ -5,6 +5,7 @@
 #include "dprintpreviewdialog.h"
 
 #include "private/dprintpreviewdialog_p.h"
+#include "private/dprinterdiscovery_p.h"
 #include "dframe.h"
 #include "diconbutton.h"
 #include "dlabel.h"
@@ -1010,18 +1011,69 @@ void DPrintPreviewDialogPrivate::marginsLayout(bool adapted)
 
 void DPrintPreviewDialogPrivate::initdata()
 {
+    Q_Q(DPrintPreviewDialog);
+
+    // 打印机列表在后台枚举，先显示已缓存的结果，之后逐步更新
+    DPrinterDiscovery *discovery = DPrinterDiscovery::instance();
     QStringList itemlist;
-    itemlist << QPrinterInfo::availablePrinterNames()
+    itemlist << discovery->printerNames()
              << qApp->translate("DPrintPreviewDialogPrivate", "Print to PDF")
              << qApp->translate("DPrintPreviewDialogPrivate", "Save as Image");
     printDeviceCombo->addItems(itemlist);
-    QString defauledevice = QPrinterInfo::defaultPrinterName();
+    QString defauledevice = discovery->defaultPrinterName();
     for (int i = 0; i < itemlist.size(); ++i) {
         if (defauledevice.compare(itemlist.at(i)) == 0) {
             printDeviceCombo->setCurrentIndex(i);
             break;
         }
     }
+
+    QObject::connect(discovery, &DPrinterDiscovery::printerAdded, q, [this](const QString &printerName) {
+        if (printDeviceCombo->findText(printerName) >= 0)
+            return;
+
+        int index = printDeviceCombo->findText(qApp->translate("DPrintPreviewDialogPrivate", "Print to PDF"));
+        if (index < 0)
+            index = printDeviceCombo->count();
+
+        // 当前选中项不变，不需要重新刷新打印属性
+        printDeviceCombo->blockSignals(true);
+        printDeviceCombo->insertItem(index, printerName);
+        printDeviceCombo->blockSignals(false);
+    });
+    QObject::connect(discovery, &DPrinterDiscovery::printerRemoved, q, [this](const QString &printerName) {
+        const int index = printDeviceCombo->findText(printerName);
+        if (index >= 0)
+            printDeviceCombo->removeItem(index);
+    });
+    // 首次打开时还没有枚举结果，枚举完成前禁用打印设备列表，完成后再选中默认打印机，
+    // 避免用户在此期间选择的设备被默认打印机替换
+    printersDiscovered = discovery->isReady();
+    printDeviceCombo->setEnabled(printersDiscovered);
+    QObject::connect(discovery, &DPrinterDiscovery::discovered, q, [this, discovery] {
+        if (printersDiscovered)
+            return;
+
+        printersDiscovered = true;
+        printDeviceCombo->setEnabled(true);
+
+        if (printerSelectedByUser)
+            return;
+
+        // 当前项改变时由 currentIndexChanged 刷新打印属性
+        const int index = printDeviceCombo->findText(discovery->defaultPrinterName());
+        if (index >= 0 && index != printDeviceCombo->currentIndex())
+            printDeviceCombo->setCurrentIndex(index);
+    });
+    QObject::connect(discovery, &DPrinterDiscovery::capabilitiesReady, q, [this](const QString &printerName) {
+        if (printerName == capabilitiesPendingPrinter && printerName == printDeviceCombo->currentText())
+            _q_printerChanged(printDeviceCombo->currentIndex());
+    });
+    QObject::connect(printDeviceCombo, QOverload<int>::of(&DComboBox::activated), q, [this] {
+        printerSelectedByUser = true;
+    });
+    discovery->refresh();
+
     _q_pageRangeChanged(0);
     _q_pageMarginChanged(0);
     _q_printerChanged(printDeviceCombo->currentIndex());
@@ -1358,13 +1410,14 @@ void DPrintPreviewDialogPrivate::setupPrinter()
 void DPrintPreviewDialogPrivate::judgeSupportedAttributes(const QString &lastPaperSize)
 {
     Q_Q(DPrintPreviewDialog);
-    QPrinterInfo updateinfo(*printer);
+    const DPrinterCapabilities capabilities = DPrinterDiscovery::instance()->capabilities(printer->printerName());
 
     QStringList pageSizeList;
     int index = -1;
-    for (int i = 0; i < updateinfo.supportedPageSizes().size(); i++) {
-        pageSizeList.append(updateinfo.supportedPageSizes().at(i).name());
-        if (index == -1 && updateinfo.supportedPageSizes().at(i).id() == QPageSize::PageSizeId::A4) {
+    for (int i = 0; i < capabilities.pageSizes.size(); i++) {
+        const QPageSize &pageSize = capabilities.pageSizes.at(i);
+        pageSizeList.append(pageSize.name());
+        if (index == -1 && pageSize.id() == QPageSize::PageSizeId::A4) {
             index = i;
         }
     }
@@ -1381,17 +1434,19 @@ void DPrintPreviewDialogPrivate::judgeSupportedAttributes(const QString &lastPap
     //判断当前打印机是否支持双面打印，不支持禁用双面打印按钮，pdf不做判断
     QString lastDuplexComboText = duplexCombo->currentText();
     duplexCombo->clear();
-    if (updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide) || updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+    const bool supportsLongSide = capabilities.supportsDuplex(QPrinter::DuplexLongSide);
+    const bool supportsShortSide = capabilities.supportsDuplex(QPrinter::DuplexShortSide);
+    if (supportsLongSide || supportsShortSide) {
         settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_DuplexWidget, true);
-        if (!updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide)) {
+        if (!supportsLongSide) {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on short edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
             supportedDuplexFlag = false;
-        } else if (!updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+        } else if (!supportsShortSide) {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on long edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
             supportedDuplexFlag = true;
-        } else if (updateinfo.supportedDuplexModes().contains(QPrinter::DuplexLongSide) && updateinfo.supportedDuplexModes().contains(QPrinter::DuplexShortSide)) {
+        } else {
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on long edge"));
             duplexCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Flip on short edge"));
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_PrintDuplex);
@@ -1660,7 +1715,9 @@ void DPrintPreviewDialogPrivate::watermarkTypeChoosed(int index)
 void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
 {
     Q_Q(DPrintPreviewDialog);
-    QString lastPaperSize = paperSizeCombo->currentText();
+    // 等待打印机能力期间纸张列表为空，使用等待前选中的纸张
+    QString lastPaperSize = capabilitiesPendingPrinter.isEmpty() ? paperSizeCombo->currentText() : pendingPaperSize;
+    capabilitiesPendingPrinter.clear();
     paperSizeCombo->clear();
     paperSizeCombo->blockSignals(true);
     QString currentName = printDeviceCombo->itemText(index);
@@ -1669,6 +1726,8 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
     colorModeCombo->blockSignals(false);
     if (isActualPrinter(currentName)) {
         //actual printer
+        // 能力在后台读取，读取完成前禁用纸张、双面和颜色设置，capabilitiesReady 后重新刷新
+        const DPrinterCapabilities capabilities = DPrinterDiscovery::instance()->capabilities(currentName);
         if (printer) {
             if (q->printFromPath().isEmpty() && !sidebysideCheckBox->isChecked()) {
                 settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_PageOrder_SequentialPrint, true);
@@ -1680,13 +1739,27 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
             settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_ColorModeWidget, true);
             printer->setPrinterName(currentName);
             printBtn->setText(qApp->translate("DPrintPreviewDialogPrivate", "Print", "button"));
-            judgeSupportedAttributes(lastPaperSize);
+            if (capabilities.loaded)
+                judgeSupportedAttributes(lastPaperSize);
+        }
+        if (!capabilities.loaded) {
+            capabilitiesPendingPrinter = currentName;
+            pendingPaperSize = lastPaperSize;
+            settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_PaperSizeWidget, false);
+            settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_DuplexWidget, false);
+            settingHelper->setSubControlEnabled(DPrintPreviewSettingInterface::SC_ColorModeWidget, false);
+            if (!isInited) {
+                waterColor = QColor("#6f6f6f");
+                _q_selectColorButton(waterColor);
+                pickColorWidget->convertColor(waterColor);
+                pickColorWidget->setRgbEdit(waterColor);
+            }
+            paperSizeCombo->blockSignals(false);
+            return;
         }
         //判断当前打印机是否支持彩色打印，不支持彩色打印删除彩色打印选择选项，pdf不做判断
-        QPlatformPrinterSupport *ps = QPlatformPrinterSupportPlugin::get();
-        QPrintDevice currentDevice = ps->createPrintDevice(printDeviceCombo->currentText());
         supportedColorMode = false;
-        if (currentDevice.supportedColorModes().contains(QPrint::Color)) {
+        if (capabilities.supportsColorMode(QPrint::Color)) {
             if (!isInited) {
                 waterColor = QColor("#6f6f6f");
                 _q_selectColorButton(waterColor);
@@ -1701,7 +1774,7 @@ void DPrintPreviewDialogPrivate::_q_printerChanged(int index)
             updateSubControlSettings(DPrintPreviewSettingInfo::PS_ColorMode);
             supportedColorMode = true;
         }
-        if (currentDevice.supportedColorModes().contains(QPrint::GrayScale)) {
+        if (capabilities.supportsColorMode(QPrint::GrayScale)) {
             colorModeCombo->blockSignals(true);
             colorModeCombo->addItem(qApp->translate("DPrintPreviewDialogPrivate", "Grayscale"));
             // Ensure that the signal CurrentIndexChanged is triggered afterwards
@@ -2189,9 +2262,8 @@ void DPrintPreviewDialogPrivate::setPageLayoutEnable(const bool &checked)
 
 void DPrintPreviewDialogPrivate::matchFitablePageSize()
 {
-    QPrinterInfo prInfo(*printer);
     if (isActualPrinter(printDeviceCombo->currentText())) {
-        auto const &pageSizes = prInfo.supportedPageSizes();
+        const QList<QPageSize> pageSizes = DPrinterDiscovery::instance()->capabilities(printer->printerName()).pageSizes;
         auto it = std::find_if(pageSizes.cbegin(), pageSizes.cend(), [&](const QPageSize &pageSize) {
             return pageSize.name() == paperSizeCombo->currentText();
         });
@@ -2225,8 +2297,7 @@ void DPrintPreviewDialogPrivate::matchFitablePageSize()
 
 bool DPrintPreviewDialogPrivate::isActualPrinter(const QString &name)
 {
-    const QStringList &printerNames = QPrinterInfo::availablePrinterNames();
-    return printerNames.contains(name);
+    return DPrinterDiscovery::instance()->contains(name);
 }
 
 /*!
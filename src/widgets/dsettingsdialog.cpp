@@ -181,6 +181,27 @@ void DSettingsDialog::setIcon(const QIcon &icon)
     d->frameBar->setIcon(icon);
 }
 
+/*!
+  @~english
+  \brief DSettingsDialog::setLazyLoadEnabled Create option widgets only when needed
+  \details When enabled, updateSettings() only creates the group titles and a placeholder
+  for each group. The option widgets of a group are created when it is scrolled into view
+  or selected in the navigation.
+  \param[in] enabled true: create widgets lazily, false: create all widgets in updateSettings()
+  \note Please call before updateSettings()
+ */
+void DSettingsDialog::setLazyLoadEnabled(bool enabled)
+{
+    D_D(DSettingsDialog);
+    d->content->setLazyLoadEnabled(enabled);
+}
+
+bool DSettingsDialog::lazyLoadEnabled() const
+{
+    Q_D(const DSettingsDialog);
+    return d->content->lazyLoadEnabled();
+}
+
 /*!
   @~english
   \brief Create all widget for settings options, that you can only call the once.
@@ -6,6 +6,7 @@
 
 #include <QDebug>
 #include <QMap>
+#include <QHash>
 #include <QFrame>
 #include <QLabel>
 #include <QEvent>
@@ -55,12 +56,52 @@ private:
     DTK_CORE_NAMESPACE::DSettingsOption *m_poption = nullptr;
 };
 
-static QMap<QString, KeySequenceEdit *> shortcutMap;
+// 快捷键与编辑控件的双向索引，每个 DSettingsWidgetFactory（即每个设置对话框）各自持有一份
+class ShortcutIndex
+{
+public:
+    KeySequenceEdit *edit(const QKeySequence &sequence) const
+    {
+        return editBySequence.value(sequence);
+    }
+    QKeySequence sequence(KeySequenceEdit *edit) const
+    {
+        return sequenceByEdit.value(edit);
+    }
+    void insert(const QKeySequence &sequence, KeySequenceEdit *edit)
+    {
+        remove(edit);
+        remove(sequence);
+
+        editBySequence.insert(sequence, edit);
+        sequenceByEdit.insert(edit, sequence);
+    }
+    void remove(const QKeySequence &sequence)
+    {
+        if (KeySequenceEdit *edit = editBySequence.take(sequence))
+            sequenceByEdit.remove(edit);
+    }
+    void remove(KeySequenceEdit *edit)
+    {
+        auto it = sequenceByEdit.find(edit);
+
+        if (it == sequenceByEdit.end())
+            return;
+
+        editBySequence.remove(it.value());
+        sequenceByEdit.erase(it);
+    }
+
+private:
+    QHash<QKeySequence, KeySequenceEdit *> editBySequence;
+    QHash<KeySequenceEdit *, QKeySequence> sequenceByEdit;
+};
 
 class ChangeDDialog : public DDialog
 {
 public:
-    ChangeDDialog(QString key, KeySequenceEdit *edit, QString text = QString())
+    ChangeDDialog(ShortcutIndex *shortcutIndex, const QKeySequence &key, KeySequenceEdit *edit, QString text = QString())
+        : shortcutIndex(shortcutIndex)
     {
         QPushButton *cancel = new QPushButton(qApp->translate("DSettingsDialog", "Cancel"));
         DSuggestButton *replace = new DSuggestButton(qApp->translate("DSettingsDialog", "Replace"));
@@ -73,11 +114,11 @@ public:
         insertButton(1, cancel);
         insertButton(1, replace);
         connect(replace, &DSuggestButton::clicked, [ = ] {  //替换
-            auto value = shortcutMap.value(key);
+            auto value = shortcutIndex->edit(key);
             value->option()->setValue(SHORTCUT_VALUE);
-            shortcutMap.remove(key);
+            shortcutIndex->remove(key);
 
-            edit->option()->setValue(key);
+            edit->option()->setValue(key.toString());
         });
         connect(cancel, &QPushButton::clicked, [ = ] {  //取消
             cancelSettings(edit);
@@ -92,12 +133,14 @@ public:
 private:
     void cancelSettings(KeySequenceEdit *edit)
     {
-        if (shortcutMap.key(edit).isEmpty()) {  //第一次被设置
+        if (shortcutIndex->sequence(edit).isEmpty()) {  //第一次被设置
             edit->clear();
         } else {
             edit->setKeySequence(edit->option()->value().toString());
         }
     }
+
+    ShortcutIndex *shortcutIndex;
 };
 
 /*!
@@ -186,14 +229,8 @@ QPair<QWidget *, QWidget *> DSettingsWidgetFactory::createStandardItem(const QBy
     return qMakePair(new QLabel(label), rightWidget);
 }
 
-QPair<QWidget *, QWidget *> createShortcutEditOptionHandle(DSettingsWidgetFactoryPrivate *p, QObject *opt)
+QPair<QWidget *, QWidget *> createShortcutEditOptionHandle(ShortcutIndex *shortcutIndex, QObject *factory, QObject *opt)
 {
-    static DSettingsWidgetFactoryPrivate *pFlg = nullptr;
-    if (pFlg != p) {
-        shortcutMap.clear();
-        pFlg = p;
-    }
-
     auto option = qobject_cast<DTK_CORE_NAMESPACE::DSettingsOption *>(opt);
     auto rightWidget = new KeySequenceEdit(option);
 
@@ -204,56 +241,60 @@ QPair<QWidget *, QWidget *> createShortcutEditOptionHandle(DSettingsWidgetFactor
     auto optionValue = option->value();
     auto translateContext = opt->property(PRIVATE_PROPERTY_translateContext).toByteArray();
 
-    option->connect(rightWidget, &KeySequenceEdit::editingFinished, [ = ](const QKeySequence & sequence) {
+    // 索引随 factory 销毁，访问索引的连接都以 factory 作为上下文，避免控件晚于 factory 销毁时访问无效的索引
+    QObject::connect(rightWidget, &KeySequenceEdit::editingFinished, factory, [ = ](const QKeySequence & sequence) {
 
-        QString keyseq = sequence.toString();
-        if (shortcutMap.value(sequence.toString()) == rightWidget) //键位于自己相同
+        KeySequenceEdit *edit = shortcutIndex->edit(sequence);
+        if (edit == rightWidget) //键位于自己相同
             return;
 
-        if (shortcutMap.value(keyseq)) {
-            ChangeDDialog frame(keyseq, rightWidget, rightWidget->text());
+        if (edit) {
+            ChangeDDialog frame(shortcutIndex, sequence, rightWidget, rightWidget->text());
             frame.setAccessibleName("ChangeDDialog");
             frame.exec();
         } else {
-            shortcutMap.remove(shortcutMap.key(rightWidget));
-            shortcutMap.insert(keyseq, rightWidget);
-            option->setValue(keyseq);
+            shortcutIndex->insert(sequence, rightWidget);
+            option->setValue(sequence.toString());
         }
     });
 
     auto updateWidgetValue = [ = ](const QVariant & optionValue, DTK_CORE_NAMESPACE::DSettingsOption * opt) {
         QKeySequence sequence(optionValue.toString());
-        QString keyseq = sequence.toString();
 
-        if (shortcutMap.value(keyseq)) {
+        if (shortcutIndex->edit(sequence)) {
             return;
         }
 
         if (rightWidget->setKeySequence(sequence)) {
-            shortcutMap.insert(keyseq, rightWidget);
-            opt->setValue(keyseq);
+            shortcutIndex->insert(sequence, rightWidget);
+            opt->setValue(sequence.toString());
         }
     };
     updateWidgetValue(optionValue, option);
 
-    option->connect(option, &DTK_CORE_NAMESPACE::DSettingsOption::valueChanged, rightWidget, [ = ](const QVariant & value) {
+    auto valueChangedConnection = QObject::connect(option, &DTK_CORE_NAMESPACE::DSettingsOption::valueChanged, factory, [ = ](const QVariant & value) {
 
         if (value.toString() == SHORTCUT_VALUE) {
             rightWidget->clear();
             return;
         }
         QKeySequence sequence(value.toString());
-        QString keyseq = sequence.toString();
 
-        shortcutMap.remove(shortcutMap.key(rightWidget));
+        shortcutIndex->remove(rightWidget);
 
         if (rightWidget->setKeySequence(sequence)) {    //设置快捷键
 
-            shortcutMap.insert(keyseq, rightWidget);
-            option->setValue(keyseq);
+            shortcutIndex->insert(sequence, rightWidget);
+            option->setValue(sequence.toString());
         }
     });
 
+    // 控件先于 factory 销毁时，断开仍会访问该控件的连接并从索引中移除
+    QObject::connect(rightWidget, &QObject::destroyed, factory, [ = ] {
+        QObject::disconnect(valueChangedConnection);
+        shortcutIndex->remove(rightWidget);
+    });
+
     return DSettingsWidgetFactory::createStandardItem(translateContext, option, rightWidget);
 }
 
@@ -619,7 +660,7 @@ public:
         itemCreateHandles.insert("checkbox", createCheckboxOptionHandle);
         itemCreateHandles.insert("lineedit", createLineEditOptionHandle);
         itemCreateHandles.insert("combobox", createComboBoxOptionHandle);
-        itemCreateHandles.insert("shortcut", std::bind(createShortcutEditOptionHandle, this, std::placeholders::_1));
+        itemCreateHandles.insert("shortcut", std::bind(createShortcutEditOptionHandle, &shortcutIndex, parent, std::placeholders::_1));
         itemCreateHandles.insert("spinbutton", createSpinButtonOptionHandle);
         itemCreateHandles.insert("buttongroup", createButtonGroupOptionHandle);
         itemCreateHandles.insert("radiogroup", createRadioGroupOptionHandle);
@@ -631,6 +672,7 @@ public:
 
     QMap<QString, std::function<DSettingsWidgetFactory::WidgetCreateHandler> > widgetCreateHandles;
     QMap<QString, std::function<DSettingsWidgetFactory::ItemCreateHandler> > itemCreateHandles;
+    ShortcutIndex shortcutIndex;
 
     DSettingsWidgetFactory *q_ptr;
     Q_DECLARE_PUBLIC(DSettingsWidgetFactory)
@@ -9,19 +9,69 @@
 #include <QPainterPath>
 #include <QTimer>
 #include <QEvent>
+#include <QCache>
+#include <QPointer>
+#include <QSet>
+#include <QApplication>
 
 #include <DObjectPrivate>
 
 DWIDGET_BEGIN_NAMESPACE
 
+// every tick moves the spinner 14 degrees, the three indicators share the same
+// colors so the picture repeats every 120 degrees, which takes 60 distinct frames.
+static constexpr int SpinnerDegreeStep = 14;
+static constexpr int SpinnerCycleDegree = 120;
+static constexpr int SpinnerFrameCount = 60;
+// spinners whose atlas would exceed this many bytes (device pixels, ARGB32) are
+// painted directly, e.g. a 64x64 spinner at ratio 2 needs about 3.9 MB.
+static constexpr qint64 SpinnerAtlasMaxBytes = 4 * 1024 * 1024;
+// the atlases are kept in a private cache, cost is counted in KiB, so that they
+// don't evict the pixmaps of the rest of the application from QPixmapCache.
+static constexpr int SpinnerAtlasCacheCost = 12 * 1024;
+
+typedef QCache<QString, QPixmap> SpinnerAtlasCache;
+Q_GLOBAL_STATIC_WITH_ARGS(SpinnerAtlasCache, spinnerAtlasCache, (SpinnerAtlasCacheCost))
+
+static QSize spinnerFrameSize(const QSize &size, qreal devicePixelRatio)
+{
+    return (QSizeF(size) * devicePixelRatio).toSize();
+}
+
+static qint64 spinnerAtlasBytes(const QSize &frameSize)
+{
+    return qint64(frameSize.width()) * SpinnerFrameCount * frameSize.height() * 4;
+}
+
+class DSpinnerPrivate;
+class DSpinnerTicker : public QObject
+{
+public:
+    explicit DSpinnerTicker(QObject *parent = nullptr);
+
+    static DSpinnerTicker *instance(bool create = true);
+
+    void add(DSpinnerPrivate *spinner);
+    void remove(DSpinnerPrivate *spinner);
+    bool contains(DSpinnerPrivate *spinner) const;
+
+private:
+    void tick();
+
+    QTimer timer;
+    QSet<DSpinnerPrivate *> spinners;
+};
+
 class DSpinnerPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
 {
 public:
     explicit DSpinnerPrivate(DSpinner *qq);
 
     QList<QColor> createDefaultIndicatorColorList(QColor color);
-
-    QTimer refreshTimer;
+    void ensureIndicatorColors();
+    void paintIndicators(QPainter *painter, const QRectF &rect, double degree) const;
+    QPixmap spriteAtlas(const QSize &size, qreal devicePixelRatio);
+    void advance();
 
     double indicatorShadowOffset = 10;
     double currentDegree = 0.0;
@@ -32,12 +82,61 @@ public:
     D_DECLARE_PUBLIC(DSpinner)
 };
 
+DSpinnerTicker::DSpinnerTicker(QObject *parent)
+    : QObject(parent)
+{
+    timer.setInterval(30);
+    connect(&timer, &QTimer::timeout, this, &DSpinnerTicker::tick);
+}
+
+// all playing spinners are driven by one timer instead of one timer each.
+DSpinnerTicker *DSpinnerTicker::instance(bool create)
+{
+    static QPointer<DSpinnerTicker> ticker;
+    if (!ticker && create)
+        ticker = new DSpinnerTicker(qApp);
+
+    return ticker;
+}
+
+void DSpinnerTicker::add(DSpinnerPrivate *spinner)
+{
+    spinners.insert(spinner);
+    if (!timer.isActive())
+        timer.start();
+}
+
+void DSpinnerTicker::remove(DSpinnerPrivate *spinner)
+{
+    spinners.remove(spinner);
+    if (spinners.isEmpty())
+        timer.stop();
+}
+
+bool DSpinnerTicker::contains(DSpinnerPrivate *spinner) const
+{
+    return spinners.contains(spinner);
+}
+
+void DSpinnerTicker::tick()
+{
+    for (auto spinner : spinners)
+        spinner->advance();
+}
+
 DSpinnerPrivate::DSpinnerPrivate(DSpinner *qq)
     : DObjectPrivate(qq)
 {
 
 }
 
+void DSpinnerPrivate::advance()
+{
+    D_Q(DSpinner);
+    currentDegree += SpinnerDegreeStep;
+    q->update();
+}
+
 /*!
 @~english
     \class Dtk::Widget::DSpinner
@@ -61,19 +160,15 @@ DSpinner::DSpinner(QWidget *parent) :
 {
     Q_D(DSpinner);
 
-    d->refreshTimer.setInterval(30);
     d->colorGroup = palette().currentColorGroup();
-
-    connect(&d->refreshTimer, &QTimer::timeout,
-    this, [ = ]() {
-        d->currentDegree += 14;
-        update();
-    });
 }
 
 DSpinner::~DSpinner()
 {
+    Q_D(DSpinner);
 
+    if (auto ticker = DSpinnerTicker::instance(false))
+        ticker->remove(d);
 }
 
 /*!
@@ -85,7 +180,8 @@ DSpinner::~DSpinner()
 bool DSpinner::isPlaying() const
 {
     Q_D(const DSpinner);
-    return d->refreshTimer.isActive();
+    auto ticker = DSpinnerTicker::instance(false);
+    return ticker && ticker->contains(const_cast<DSpinnerPrivate *>(d));
 }
 
 /*!
@@ -95,7 +191,7 @@ bool DSpinner::isPlaying() const
 void DSpinner::start()
 {
     Q_D(DSpinner);
-    d->refreshTimer.start();
+    DSpinnerTicker::instance()->add(d);
 }
 
 /*!
@@ -105,7 +201,8 @@ void DSpinner::start()
 void DSpinner::stop()
 {
     Q_D(DSpinner);
-    d->refreshTimer.stop();
+    if (auto ticker = DSpinnerTicker::instance(false))
+        ticker->remove(d);
 }
 
 /*!
@@ -129,25 +226,58 @@ void DSpinner::paintEvent(QPaintEvent *)
         d->indicatorColors.clear();
     }
 
-    if (d->indicatorColors.isEmpty()) {
-        for (int i = 0; i < 3; ++i)
-            d->indicatorColors << d->createDefaultIndicatorColorList(palette().highlight().color());
-    }
+    d->ensureIndicatorColors();
 
     QPainter painter(this);
-    painter.setRenderHints(QPainter::Antialiasing);
 
-    auto degreeCurrent = d->currentDegree * 1.0;
+    const qreal ratio = devicePixelRatioF();
+    const QSize frameSize = spinnerFrameSize(size(), ratio);
+
+    if (spinnerAtlasBytes(frameSize) > SpinnerAtlasMaxBytes) {
+        painter.setRenderHints(QPainter::Antialiasing);
+        d->paintIndicators(&painter, rect(), d->currentDegree);
+        return;
+    }
+
+    const QPixmap &atlas = d->spriteAtlas(size(), ratio);
+    const int frame = qRound(std::fmod(d->currentDegree, SpinnerCycleDegree)) * SpinnerFrameCount / SpinnerCycleDegree;
+
+    painter.drawPixmap(rect(), atlas, QRect(QPoint(frame * frameSize.width(), 0), frameSize));
+}
+
+void DSpinner::changeEvent(QEvent *e)
+{
+    Q_D(DSpinner);
+
+    if (e->type() == QEvent::PaletteChange)
+        d->indicatorColors.clear();
+
+    QWidget::changeEvent(e);
+}
+
+void DSpinnerPrivate::ensureIndicatorColors()
+{
+    D_Q(DSpinner);
+
+    if (indicatorColors.isEmpty()) {
+        for (int i = 0; i < 3; ++i)
+            indicatorColors << createDefaultIndicatorColorList(q->palette().highlight().color());
+    }
+}
 
-    auto center = QRectF(rect()).center();
-    auto radius = qMin(rect().width(), rect().height()) / 2.0;
+void DSpinnerPrivate::paintIndicators(QPainter *painter, const QRectF &rect, double degree) const
+{
+    auto degreeCurrent = degree * 1.0;
+
+    auto center = rect.center();
+    auto radius = qMin(rect.width(), rect.height()) / 2.0;
     auto indicatorRadius = radius / 2 / 2 * 1.1;
-    auto indicatorDegreeDelta = 360 / d->indicatorColors.count();
+    auto indicatorDegreeDelta = 360 / indicatorColors.count();
 
-    for (int i = 0; i <  d->indicatorColors.count(); ++i) {
-        auto colors = d->indicatorColors.value(i);
+    for (int i = 0; i < indicatorColors.count(); ++i) {
+        auto colors = indicatorColors.value(i);
         for (int j = 0; j < colors.count(); ++j) {
-            degreeCurrent = d->currentDegree - j * d->indicatorShadowOffset + indicatorDegreeDelta * i;
+            degreeCurrent = degree - j * indicatorShadowOffset + indicatorDegreeDelta * i;
             auto x = (radius - indicatorRadius) * qCos(qDegreesToRadians(degreeCurrent));
             auto y = (radius - indicatorRadius) * qSin(qDegreesToRadians(degreeCurrent));
 
@@ -159,19 +289,43 @@ void DSpinner::paintEvent(QPaintEvent *)
             QPainterPath path;
             path.addEllipse(rf);
 
-            painter.fillPath(path, colors.value(j));
+            painter->fillPath(path, colors.value(j));
         }
     }
 }
 
-void DSpinner::changeEvent(QEvent *e)
+/*!
+  \internal
+  Renders one full rotation cycle side by side into a single pixmap, shared
+  by all spinners of the same size, ratio and color.
+ */
+QPixmap DSpinnerPrivate::spriteAtlas(const QSize &size, qreal devicePixelRatio)
 {
-    Q_D(DSpinner);
+    const QColor &color = indicatorColors.value(0).value(0);
+    const QString &key = QString("dtk-spinner-%1x%2-%3-%4").arg(size.width()).arg(size.height())
+                                 .arg(devicePixelRatio).arg(color.name(QColor::HexArgb));
 
-    if (e->type() == QEvent::PaletteChange)
-        d->indicatorColors.clear();
+    if (const QPixmap *atlas = spinnerAtlasCache->object(key))
+        return *atlas;
 
-    QWidget::changeEvent(e);
+    const QSize frameSize = spinnerFrameSize(size, devicePixelRatio);
+    QImage image(frameSize.width() * SpinnerFrameCount, frameSize.height(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing);
+    for (int i = 0; i < SpinnerFrameCount; ++i) {
+        painter.resetTransform();
+        painter.setClipRect(QRect(QPoint(i * frameSize.width(), 0), frameSize));
+        painter.setTransform(QTransform::fromTranslate(i * frameSize.width(), 0).scale(devicePixelRatio, devicePixelRatio));
+        paintIndicators(&painter, QRectF(QPointF(0, 0), size), i * SpinnerCycleDegree / SpinnerFrameCount);
+    }
+    painter.end();
+
+    const QPixmap atlas = QPixmap::fromImage(image);
+    spinnerAtlasCache->insert(key, new QPixmap(atlas), int(spinnerAtlasBytes(frameSize) / 1024));
+
+    return atlas;
 }
 
 QList<QColor> DSpinnerPrivate::createDefaultIndicatorColorList(QColor color)
@@ -31,6 +31,8 @@
 #include "dpalettehelper.h"
 #include "diconbutton.h"
 
+#include <typeinfo>
+
 DWIDGET_BEGIN_NAMESPACE
 
 // TODO: Replace with verticalTabs in qtabbar_p.h when all versions of Qt support.
@@ -140,6 +142,7 @@ public:
         connect(this, &QTabBar::tabMoved, this, [this] (int from, int to) {
             tabMinimumSize.move(from, to);
             tabMaximumSize.move(from, to);
+            tabSizeHintCache.move(from, to);
 
             if (dd()->validIndex(ghostTabIndex)) {
                 if (from == ghostTabIndex)
@@ -409,9 +412,20 @@ public:
 
     void onCurrentChanged(int current);
     void updateCloseButtonVisible();
+    QWidget *closeButton(int index) const;
+
+    QSize cachedTabSizeHint(int index) const;
+    QPixmap tabPixmap(int index, const QStyleOptionTab &option, const QSize &size) const;
+    void invalidateTabSizeHint(int index = -1);
 
     QList<QSize> tabMinimumSize;
     QList<QSize> tabMaximumSize;
+    // QTabBar::tabSizeHint 需要测量文本，布局时每个标签页都会调用，缓存其结果
+    mutable QList<QSize> tabSizeHintCache;
+    QPointer<QWidget> visibleCloseButton;
+    // 拖动及移动标签页时绘制的图片，按标签页及其外观缓存，与标签页的位置无关，
+    // 插入、移除标签页和标签页的文本、图标、数据、字体、调色板及样式变化时失效
+    mutable QHash<QString, QPixmap> tabPixmapCache;
     bool visibleAddButton = true;
     DIconButton *addButton;
     QPointer<QDrag> drag;
@@ -504,16 +518,6 @@ void DTabBarPrivate::setupMovableTab()
     else
         grabRect.adjust(-taboverlap, 0, taboverlap, 0);
 
-    QPixmap grabImage(grabRect.size() * devicePixelRatioF());
-    grabImage.setDevicePixelRatio(devicePixelRatioF());
-    grabImage.fill(Qt::transparent);
-    QPainter p(&grabImage);
-#if QT_VERSION< QT_VERSION_CHECK(5, 13, 0)
-    p.initFrom(this);
-#else
-    p.begin(this);
-#endif
-
     QStyleOptionTab tab;
     initStyleOption(&tab, d->pressedIndex);
     tab.position = QStyleOptionTab::OnlyOneTab;
@@ -523,8 +527,8 @@ void DTabBarPrivate::setupMovableTab()
         tab.rect.moveTopLeft(QPoint(taboverlap, 0));
     // 强制让文本居中
     tab.rightButtonSize = QSize();
-    q_func()->paintTab(&p, d->pressedIndex, tab);
-    p.end();
+
+    const QPixmap &grabImage = tabPixmap(d->pressedIndex, tab, grabRect.size());
 
     reinterpret_cast<DMovableTabWidget*>(d->movingTab)->setPixmap(grabImage);
     d->movingTab->setGeometry(grabRect);
@@ -1059,7 +1063,19 @@ void DTabBarPrivate::stopMove()
 
 void DTabBarPrivate::onCurrentChanged(int current)
 {
-    updateCloseButtonVisible();
+    // 切换标签页时只需要隐藏之前的关闭按钮并显示当前的，无需遍历所有标签页
+    if (tabsClosable()) {
+        QWidget *close_button = closeButton(current);
+
+        if (visibleCloseButton && visibleCloseButton != close_button)
+            visibleCloseButton->setVisible(false);
+
+        if (close_button)
+            close_button->setVisible(true);
+
+        visibleCloseButton = close_button;
+    }
+
     D_Q(DTabBar);
     Q_EMIT q->currentChanged(current);
 }
@@ -1071,18 +1087,112 @@ void DTabBarPrivate::updateCloseButtonVisible()
         return;
 
     int current = currentIndex();
+    visibleCloseButton = nullptr;
 
     for (int i = 0; i < this->count(); ++i) {
-        QWidget *close_button = tabButton(i, QTabBar::RightSide);
+        QWidget *close_button = closeButton(i);
 
-        if (!close_button || close_button->metaObject()->className() != QByteArrayLiteral("CloseButton")) {
-            close_button = tabButton(i, QTabBar::LeftSide);
-        }
-
-        if (!close_button || close_button->metaObject()->className() != QByteArrayLiteral("CloseButton"))
+        if (!close_button)
             continue;
 
         close_button->setVisible(i == current);
+
+        if (i == current)
+            visibleCloseButton = close_button;
+    }
+}
+
+QWidget *DTabBarPrivate::closeButton(int index) const
+{
+    if (index < 0 || index >= count())
+        return nullptr;
+
+    QWidget *close_button = tabButton(index, QTabBar::RightSide);
+
+    if (!close_button || close_button->metaObject()->className() != QByteArrayLiteral("CloseButton")) {
+        close_button = tabButton(index, QTabBar::LeftSide);
+    }
+
+    if (!close_button || close_button->metaObject()->className() != QByteArrayLiteral("CloseButton"))
+        return nullptr;
+
+    return close_button;
+}
+
+QSize DTabBarPrivate::cachedTabSizeHint(int index) const
+{
+    // 插入或移除标签页的过程中 QTabBar 会先重新布局再通知 tabInserted/tabRemoved，
+    // 此时缓存与标签页并不对应，不能使用
+    if (index < 0 || index >= tabSizeHintCache.size() || tabSizeHintCache.size() != count())
+        return QTabBar::tabSizeHint(index);
+
+    QSize &size = tabSizeHintCache[index];
+
+    if (!size.isValid())
+        size = QTabBar::tabSizeHint(index);
+
+    return size;
+}
+
+QPixmap DTabBarPrivate::tabPixmap(int index, const QStyleOptionTab &option, const QSize &size) const
+{
+    const qreal ratio = devicePixelRatioF();
+    // 子类重写的 paintTab 可能依赖 tabData 或自身的状态，无法判断何时失效，不使用缓存
+    const bool cacheable = typeid(*q_func()) == typeid(DTabBar);
+    const QString key = QStringList {
+        QString::number(quintptr(dd()->at(index)), 16),
+        option.text,
+        QString::number(option.icon.cacheKey()),
+        QString::number(option.iconSize.width()),
+        QString::number(option.iconSize.height()),
+        QString::number(option.state),
+        QString::number(option.shape),
+        QString::number(option.position),
+        QString::number(option.selectedPosition),
+        QString::number(option.rect.width()),
+        QString::number(option.rect.height()),
+        QString::number(size.width()),
+        QString::number(size.height()),
+        QString::number(ratio),
+        QString::number(option.palette.cacheKey()),
+        font().key(),
+    }.join(QLatin1Char('-'));
+
+    auto it = cacheable ? tabPixmapCache.constFind(key) : tabPixmapCache.constEnd();
+    if (it != tabPixmapCache.constEnd())
+        return it.value();
+
+    QPixmap grabImage(size * ratio);
+    grabImage.setDevicePixelRatio(ratio);
+    grabImage.fill(Qt::transparent);
+    QPainter p(&grabImage);
+#if QT_VERSION< QT_VERSION_CHECK(5, 13, 0)
+    p.initFrom(this);
+#else
+    p.begin(const_cast<DTabBarPrivate *>(this));
+#endif
+    q_func()->paintTab(&p, index, option);
+    p.end();
+
+    if (!cacheable)
+        return grabImage;
+
+    // 悬停、按下等状态会产生新的条目，避免无限增长
+    if (tabPixmapCache.size() >= qMax(16, count() * 2))
+        tabPixmapCache.clear();
+
+    tabPixmapCache.insert(key, grabImage);
+
+    return grabImage;
+}
+
+void DTabBarPrivate::invalidateTabSizeHint(int index)
+{
+    if (index < 0) {
+        for (QSize &size : tabSizeHintCache)
+            size = QSize();
+    } else if (index < tabSizeHintCache.size()) {
+        tabSizeHintCache[index] = QSize();
     }
 }
 
@@ -1177,6 +1287,11 @@ bool DTabBarPrivate::event(QEvent *e)
         mousePress = true;
     } if (e->type() == QEvent::MouseButtonRelease && mouseEvent->button() == Qt::LeftButton) {
         mousePress = false;
+    } if (e->type() == QEvent::FontChange || e->type() == QEvent::StyleChange) {
+        invalidateTabSizeHint();
+        tabPixmapCache.clear();
+    } if (e->type() == QEvent::PaletteChange) {
+        tabPixmapCache.clear();
     }
     return QTabBar::event(e);
 }
@@ -1214,30 +1329,30 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
         selected = d->pressedIndex;
     const QRect scrollRect = d->normalizedScrollRect();
 
-    for (int i = 0; i < d->tabList.count(); ++i)
-         optTabBase.tabBarRect |= tabRect(i);
+    // 每个标签页的位置只计算一次，初始化 QStyleOptionTab（需要计算省略文本）的开销较大，
+    // 只对可见以及需要绘制撕裂指示器的标签页进行
+    const int tabCount = d->tabList.count();
+    QVector<QRect> tabRects(tabCount);
+    for (int i = 0; i < tabCount; ++i) {
+        tabRects[i] = tabRect(i);
+        optTabBase.tabBarRect |= tabRects.at(i);
+    }
 
-    optTabBase.selectedTabRect = tabRect(selected);
+    optTabBase.selectedTabRect = tabRects.value(selected);
 
     if (d->drawBase)
         p.drawPrimitive(QStyle::PE_FrameTabBarBase, optTabBase);
 
-    for (int i = 0; i < d->tabList.count(); ++i) {
-        QStyleOptionTab tab;
-        initStyleOption(&tab, i);
-        // 强制让文本居中
-        tab.rightButtonSize = QSize();
+    for (int i = 0; i < tabCount; ++i) {
+        QRect rect = tabRects.at(i);
 
         if (d->paintWithOffsets && d->at(i)->dragOffset != 0) {
             if (vertical) {
-                tab.rect.moveTop(tab.rect.y() + d->at(i)->dragOffset);
+                rect.moveTop(rect.y() + d->at(i)->dragOffset);
             } else {
-                tab.rect.moveLeft(tab.rect.x() + d->at(i)->dragOffset);
+                rect.moveLeft(rect.x() + d->at(i)->dragOffset);
             }
         }
-        if (!(tab.state & QStyle::State_Enabled)) {
-            tab.palette.setCurrentColorGroup(QPalette::Disabled);
-        }
 
         // If this tab is partially obscured, make a note of it so that we can
         // pass the information along when we draw the tear.
@@ -1248,21 +1363,29 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
         int tabEnd = vertical ? tabRect.bottom() : tabRect.right();
         if (tabStart < scrollRect.left() + d->scrollOffset) {
             cutLeft = i;
-            cutTabLeft = tab;
         } else if (tabEnd > scrollRect.right() + d->scrollOffset) {
             cutRight = i;
-            cutTabRight = tab;
         }
 
         // Don't bother drawing a tab if the entire tab is outside of the visible tab bar.
-        if ((!vertical && (tab.rect.right() < 0 || tab.rect.left() > width()))
-            || (vertical && (tab.rect.bottom() < 0 || tab.rect.top() > height())))
+        if ((!vertical && (rect.right() < 0 || rect.left() > width()))
+            || (vertical && (rect.bottom() < 0 || rect.top() > height())))
             continue;
 
-        optTabBase.tabBarRect |= tab.rect;
+        optTabBase.tabBarRect |= rect;
         if (i == selected)
             continue;
 
+        QStyleOptionTab tab;
+        initStyleOption(&tab, i);
+        // 强制让文本居中
+        tab.rightButtonSize = QSize();
+        tab.rect = rect;
+
+        if (!(tab.state & QStyle::State_Enabled)) {
+            tab.palette.setCurrentColorGroup(QPalette::Disabled);
+        }
+
         q->paintTab(&p, i, tab);
 //        p.drawControl(QStyle::CE_TabBarTab, tab); // Qt源码写法
 
@@ -1308,12 +1431,14 @@ void DTabBarPrivate::paintEvent(QPaintEvent *e)
 
     // Only draw the tear indicator if necessary. Most of the time we don't need too.
     if (d->leftB->isVisible() && cutLeft >= 0) {
+        initStyleOption(&cutTabLeft, cutLeft);
         cutTabLeft.rect = rect();
         cutTabLeft.rect = style()->subElementRect(QStyle::SE_TabBarTearIndicatorLeft, &cutTabLeft, this);
         p.drawPrimitive(QStyle::PE_IndicatorTabTearLeft, cutTabLeft);
     }
 
     if (d->rightB->isVisible() && cutRight >= 0) {
+        initStyleOption(&cutTabRight, cutRight);
         cutTabRight.rect = rect();
         cutTabRight.rect = style()->subElementRect(QStyle::SE_TabBarTearIndicatorRight, &cutTabRight, this);
         p.drawPrimitive(QStyle::PE_IndicatorTabTearRight, cutTabRight);
@@ -1490,7 +1615,7 @@ QSize DTabBarPrivate::minimumTabSizeHint(int index) const
     if (min.isValid())
         return min;
 
-    QSize size = QTabBar::tabSizeHint(index);
+    QSize size = cachedTabSizeHint(index);
     const QSize &max = q->maximumTabSizeHint(index);
 
     if (max.width() > 0) {
@@ -1508,6 +1633,7 @@ void DTabBarPrivate::tabInserted(int index)
 {
     D_Q(DTabBar);
 
+    tabPixmapCache.clear();
     q->tabInserted(index);
 }
 
@@ -1515,6 +1641,8 @@ void DTabBarPrivate::tabRemoved(int index)
 {
     D_Q(DTabBar);
 
+    // 被移除的标签页的地址可能被新的标签页复用
+    tabPixmapCache.clear();
     q->tabRemoved(index);
 }
 
@@ -1730,6 +1858,7 @@ void DTabBar::setShape(QTabBar::Shape shape)
     bool old_vertical = dtk_verticalTabs(d_func()->shape());
     bool new_vertical = dtk_verticalTabs(shape);
 
+    d->invalidateTabSizeHint();
     d->setShape(shape);
 
     if (old_vertical != new_vertical) {
@@ -1872,6 +2001,8 @@ QString DTabBar::tabText(int index) const
  */
 void DTabBar::setTabText(int index, const QString &text)
 {
+    d_func()->invalidateTabSizeHint(index);
+    d_func()->tabPixmapCache.clear();
     d_func()->setTabText(index, text);
 }
 
@@ -1895,6 +2026,8 @@ QIcon DTabBar::tabIcon(int index) const
  */
 void DTabBar::setTabIcon(int index, const QIcon &icon)
 {
+    d_func()->invalidateTabSizeHint(index);
+    d_func()->tabPixmapCache.clear();
     d_func()->setTabIcon(index, icon);
 }
 
@@ -1965,6 +2098,7 @@ QString DTabBar::tabWhatsThis(int index) const
  */
 void DTabBar::setTabData(int index, const QVariant &data)
 {
+    d_func()->tabPixmapCache.clear();
     d_func()->setTabData(index, data);
 }
 
@@ -2059,6 +2193,7 @@ QSize DTabBar::iconSize() const
  */
 void DTabBar::setIconSize(const QSize &size)
 {
+    d_func()->invalidateTabSizeHint();
     d_func()->setIconSize(size);
 }
 
@@ -2091,11 +2226,13 @@ bool DTabBar::tabsClosable() const
  */
 void DTabBar::setTabsClosable(bool closable)
 {
+    d_func()->invalidateTabSizeHint();
     d_func()->setTabsClosable(closable);
 }
 
 void DTabBar::setTabButton(int index, QTabBar::ButtonPosition position, QWidget *widget)
 {
+    d_func()->invalidateTabSizeHint(index);
     d_func()->setTabButton(index, position, widget);
 }
 
@@ -2167,6 +2304,7 @@ bool DTabBar::documentMode() const
 
 void DTabBar::setDocumentMode(bool set)
 {
+    d_func()->invalidateTabSizeHint();
     d_func()->setDocumentMode(set);
 }
 
@@ -2228,6 +2366,7 @@ void DTabBar::setEnabledEmbedStyle(bool enable)
     D_D(DTabBar);
 
     setProperty("_d_dtk_tabbartab_type", enable);
+    d->tabPixmapCache.clear();
 
     int radius;
     QSize size;
@@ -2256,6 +2395,7 @@ void DTabBar::setEnabledEmbedStyle(bool enable)
  */
 void DTabBar::setTabLabelAlignment(Qt::Alignment alignment)
 {
+    d_func()->tabPixmapCache.clear();
     setProperty("_d_dtk_tabbar_alignment", int(alignment));
 }
 
@@ -2471,25 +2611,13 @@ QPixmap DTabBar::createDragPixmapFromTab(int index, const QStyleOptionTab &optio
 {
     Q_UNUSED(hotspot)
 
-    QPixmap grabImage(option.rect.size() * devicePixelRatioF());
-    grabImage.setDevicePixelRatio(devicePixelRatioF());
-    grabImage.fill(Qt::transparent);
-
     QStyleOptionTab tab = option;
 
     int taboverlap = style()->pixelMetric(QStyle::PM_TabBarTabOverlap, 0, this);
 
     tab.rect.moveTopLeft(QPoint(taboverlap, 0));
 
-    QPainter p(&grabImage);
-#if QT_VERSION < QT_VERSION_CHECK(5, 13, 0)
-    p.initFrom(d_func());
-#else
-    p.begin(const_cast<DTabBarPrivate *>(d_func()));
-#endif
-    paintTab(&p, index, tab);
-
-    return grabImage;
+    return d_func()->tabPixmap(index, tab, option.rect.size());
 }
 
 QMimeData *DTabBar::createMimeDataFromTab(int index, const QStyleOptionTab &option) const
@@ -2528,6 +2656,7 @@ void DTabBar::tabInserted(int index)
 
     d->tabMaximumSize.insert(index, QSize());
     d->tabMinimumSize.insert(index, QSize());
+    d->tabSizeHintCache.insert(index, QSize());
 
     d->QTabBar::tabInserted(index);
 
@@ -2547,6 +2676,7 @@ void DTabBar::tabRemoved(int index)
 
     d->tabMaximumSize.removeAt(index);
     d->tabMinimumSize.removeAt(index);
+    d->tabSizeHintCache.removeAt(index);
 
     d->QTabBar::tabRemoved(index);
 
@@ -2557,7 +2687,7 @@ QSize DTabBar::tabSizeHint(int index) const
 {
     D_DC(DTabBar);
 
-    QSize size = d->QTabBar::tabSizeHint(index);
+    QSize size = d->cachedTabSizeHint(index);
 
     QTabBarPrivate *dd = reinterpret_cast<QTabBarPrivate *>(qGetPtrHelper(d->d_ptr));
     bool is_vertical = dtk_verticalTabs(dd->shape);
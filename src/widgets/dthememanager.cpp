@@ -3,8 +3,10 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include <QDebug>
+#include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QWidget>
 #include <QStyle>
 #include <QStyleFactory>
@@ -157,6 +159,53 @@ static void inseritStyle(QWidget *widget, const QWidget *baseWidget)
     widget->setStyle(base_style);
 }
 
+// DThemeManager 最后一次追加到控件样式表末尾的主题样式
+static const char *appendedQssProp = "_d_dtk_theme_appended_qss";
+
+// 样式表仍以上次追加的同一份样式结尾时，再追加一次不会改变层叠结果，跳过以免 Qt 重新解析样式表
+static void appendStyleSheet(QWidget *widget, const QString &qss)
+{
+    const QString &styleSheet = widget->styleSheet();
+
+    if (qss.isEmpty()) {
+        return;
+    }
+
+    if (widget->property(appendedQssProp).toString() == qss && styleSheet.endsWith(qss)) {
+        return;
+    }
+
+    widget->setStyleSheet(styleSheet + qss);
+    widget->setProperty(appendedQssProp, qss);
+}
+
+static void replaceStyleSheet(QWidget *widget, const QString &qss)
+{
+    widget->setProperty(appendedQssProp, qss);
+
+    if (widget->styleSheet() == qss) {
+        return;
+    }
+
+    widget->setStyleSheet(qss);
+}
+
+// 属性变化后重新匹配样式规则。QStyleSheetStyle::unpolish 会丢弃控件已解析的样式表缓存，
+// polish 时重新解析。子控件可能被依赖该属性的后代选择器匹配（如 DFoo[state="x"] QLabel），
+// 因此整个子树都要刷新，但不像 setStyleSheet 那样重新解析样式表本身
+static void repolishWidget(QWidget *widget)
+{
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+    widget->update();
+
+    for (QWidget *child : widget->findChildren<QWidget *>()) {
+        child->style()->unpolish(child);
+        child->style()->polish(child);
+        child->update();
+    }
+}
+
 static void updateWidgetTheme(DThemeManager *manager, QWidget *widget, QWidget *baseWidget, const QString &theme)
 {
     inseritStyle(widget, baseWidget);
@@ -178,8 +227,15 @@ class DThemeManagerPrivate : public DCORE_NAMESPACE::DObjectPrivate
 {
     D_DECLARE_PUBLIC(DThemeManager)
 
+    struct QssCache {
+        QDateTime lastModified;
+        QString content;
+    };
+
     QString themeName;
     QMap<QWidget *, QMap<QString, QString> > watchedDynamicProperties;
+    // 主题文件内容缓存，以文件路径为键，文件修改时间变化后重新读取
+    mutable QHash<QString, QssCache> qssCache;
 
 public:
     DThemeManagerPrivate(DThemeManager *qq)
@@ -187,11 +243,18 @@ public:
 
     QString getQssContent(const QString &themeURL) const
     {
+        const QDateTime &lastModified = QFileInfo(themeURL).lastModified();
+        auto it = qssCache.constFind(themeURL);
+        if (it != qssCache.constEnd() && it->lastModified == lastModified) {
+            return it->content;
+        }
+
         QString qss;
         QFile themeFile(themeURL);
         if (themeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
             qss = themeFile.readAll();
             themeFile.close();
+            qssCache.insert(themeURL, {lastModified, qss});
         } else {
             /// !!! if do not privode qss file, do not register it!!!
             qWarning() << "open qss file failed" << themeURL << themeFile.errorString();
@@ -275,7 +338,7 @@ public:
         auto themeurl = themeURL(fallbackWidgetThemeName(widget), filename);
 
         auto dtm = DThemeManager::instance();
-        widget->setStyleSheet(widget->styleSheet() + dtm->d_func()->getQssContent(themeurl));
+        appendStyleSheet(widget, dtm->d_func()->getQssContent(themeurl));
         widget->style()->polish(widget);
 
         auto reloadTheme = [this, dtm](QWidget * widget, const QString & filename, const QString & themename) {
@@ -283,10 +346,10 @@ public:
             auto themeurl = themeURL(fallbackWidgetThemeName(widget), filename);
             auto reloadTheme = widget->property(baseClassReloadThemeProp).toString();
             if (reloadTheme != themename) {
-                widget->setStyleSheet(dtm->d_func()->getQssContent(themeurl));
+                replaceStyleSheet(widget, dtm->d_func()->getQssContent(themeurl));
                 widget->setProperty(baseClassReloadThemeProp, themename);
             } else {
-                widget->setStyleSheet(widget->styleSheet() + dtm->d_func()->getQssContent(themeurl));
+                appendStyleSheet(widget, dtm->d_func()->getQssContent(themeurl));
             }
         };
 
@@ -559,7 +622,7 @@ void DThemeManager::updateQss()
 {
     QWidget *w = qobject_cast<QWidget *>(sender());
     if (w) {
-        w->setStyleSheet(w->styleSheet());
+        repolishWidget(w);
     }
 }
 
@@ -590,10 +653,7 @@ bool DThemeManager::eventFilter(QObject *watched, QEvent *event)
     auto props = d->watchedDynamicProperties.value(widget);
     auto propName = QString::fromLatin1(propEvent->propertyName().data());
     if (props.contains(propName) && widget) {
-        widget->setStyleSheet(widget->styleSheet());
-        widget->style()->unpolish(widget);
-        widget->style()->polish(widget);
-        widget->update();
+        repolishWidget(widget);
     }
 
     return QObject::eventFilter(watched, event);
@@ -73,6 +73,8 @@ private:
     void updateButtonsState(Qt::WindowFlags type);
     void updateButtonsFunc();
     void updateCenterArea();
+    void scheduleGeometryUpdate();
+    void updateGeometries();
 
     void handleParentWindowStateChange();
     void handleParentWindowIdChange();
@@ -171,6 +173,7 @@ private:
     bool                autoHideOnFullscreen = false;
     bool                fullScreenButtonVisible = true;
     bool                splitScreenWidgetEnable = true;
+    bool                geometryUpdatePending = false;
     QTimer              *maxButtonPressAndHoldTimer = nullptr;
     QWidget             *sidebarBackgroundWidget = nullptr;
     DTitlebarSettingsImpl *titlebarSettingsImpl = nullptr;
@@ -523,6 +526,58 @@ void DTitlebarPrivate::updateCenterArea()
     centerArea->setGeometry(rect);
 }
 
+// Interactive resizing delivers many resize events per frame, collect the geometry
+// work of all of them into a single pass handled by the (compressed) LayoutRequest.
+void DTitlebarPrivate::scheduleGeometryUpdate()
+{
+    D_Q(DTitlebar);
+
+    if (geometryUpdatePending)
+        return;
+
+    geometryUpdatePending = true;
+    QCoreApplication::postEvent(q, new QEvent(QEvent::LayoutRequest));
+}
+
+void DTitlebarPrivate::updateGeometries()
+{
+    D_Q(DTitlebar);
+
+    geometryUpdatePending = false;
+
+    const QSize size = q->size();
+    if (separatorTop->width() != size.width())
+        separatorTop->setFixedWidth(size.width());
+    if (separator->width() != size.width())
+        separator->setFixedWidth(size.width());
+    int x = (sidebarHelper && sidebarHelper->expanded()) ? sidebarHelper->width() : 0;
+    separator->move(x, size.height() - separator->height());
+
+    if (blurWidget && blurWidget->size() != size) {
+        blurWidget->resize(size);
+    }
+
+    if (sidebarBackgroundWidget && sidebarBackgroundWidget->height() != size.height())
+        sidebarBackgroundWidget->setFixedHeight(size.height());
+
+    if (titlebarSettingsImpl && titlebarSettingsImpl->hasEditPanel() && titlebarSettingsImpl->toolsEditPanel()->isVisible()) {
+        auto editPanel = titlebarSettingsImpl->toolsEditPanel();
+        if (editPanel->minimumWidth() >= size.width()) {
+            editPanel->setWindowFlag(Qt::Dialog);
+            editPanel->show();
+            int panelX = q->mapToGlobal(q->pos()).x() - (editPanel->width() - size.width()) / 2 ;
+            editPanel->move(panelX, q->mapToGlobal(q->pos()).y() + size.height());
+        } else {
+            editPanel->setWindowFlag(Qt::Dialog, false);
+            editPanel->show();
+            editPanel->move(0, size.height());
+            editPanel->resize(size.width(), q->parentWidget()->height() * 70 / 100);
+        }
+    }
+
+    updateCenterArea();
+}
+
 void DTitlebarPrivate::handleParentWindowStateChange()
 {
     maxButton->setMaximized(targetWindow()->windowState().testFlag(Qt::WindowMaximized));
@@ -1096,7 +1151,7 @@ bool DTitlebar::eventFilter(QObject *obj, QEvent *event)
             d->updateButtonsState(d->targetWindow()->windowFlags());
             break;
         case QEvent::Resize:
-            if (d->autoHideOnFullscreen) {
+            if (d->autoHideOnFullscreen && width() != d->targetWindow()->width()) {
                 setFixedWidth(d->targetWindow()->width());
             }
             break;
@@ -1158,7 +1213,11 @@ bool DTitlebar::event(QEvent *e)
     if (e->type() == QEvent::LayoutRequest) {
         D_D(DTitlebar);
 
-        d->updateCenterArea();
+        if (d->geometryUpdatePending) {
+            d->updateGeometries();
+        } else {
+            d->updateCenterArea();
+        }
     }
 
     if (e->type() == QEvent::FocusIn) {
@@ -1182,32 +1241,9 @@ void DTitlebar::resizeEvent(QResizeEvent *event)
     //override QWidget::resizeEvent to fix button and separator pos.
     D_D(DTitlebar);
 
-    d->separatorTop->setFixedWidth(event->size().width());
-    d->separator->setFixedWidth(event->size().width());
-    int x = (d->sidebarHelper && d->sidebarHelper->expanded()) ? d->sidebarHelper->width() : 0;
-    d->separator->move(x, height() - d->separator->height());
-    d->updateCenterArea();
-
-    if (d->blurWidget) {
-        d->blurWidget->resize(event->size());
-    }
-
-    if (d->sidebarBackgroundWidget)
-        d->sidebarBackgroundWidget->setFixedHeight(event->size().height());
-
-    if (d->titlebarSettingsImpl && d->titlebarSettingsImpl->hasEditPanel() && d->titlebarSettingsImpl->toolsEditPanel()->isVisible()) {
-        if (d->titlebarSettingsImpl->toolsEditPanel()->minimumWidth() >= this->width()) {
-            d->titlebarSettingsImpl->toolsEditPanel()->setWindowFlag(Qt::Dialog);
-            d->titlebarSettingsImpl->toolsEditPanel()->show();
-            int x = this->mapToGlobal(this->pos()).x() - (d->titlebarSettingsImpl->toolsEditPanel()->width()- this->width()) / 2 ;
-            d->titlebarSettingsImpl->toolsEditPanel()->move(x, this->mapToGlobal(this->pos()).y() + this->height());
-        } else {
-            d->titlebarSettingsImpl->toolsEditPanel()->setWindowFlag(Qt::Dialog, false);
-            d->titlebarSettingsImpl->toolsEditPanel()->show();
-            d->titlebarSettingsImpl->toolsEditPanel()->move(0, this->height());
-            d->titlebarSettingsImpl->toolsEditPanel()->resize(width(), parentWidget()->height() * 70 / 100);
-        }
-    }
+    // the separators, center area, blur and sidebar background are updated
+    // together once all pending resize events of this frame are delivered.
+    d->scheduleGeometryUpdate();
 
     return QWidget::resizeEvent(event);
 }
@@ -7,12 +7,15 @@
 
 #include <DPlatformWindowHandle>
 
+#include <QCache>
 #include <QDebug>
 #include <QEvent>
 #include <QTimer>
 #include <QToolTip>
 #include <QTextLayout>
 
+Q_DECLARE_METATYPE(QTextOption)
+
 DWIDGET_BEGIN_NAMESPACE
 namespace DToolTipStatic {
 static inline void registerDToolTipMetaType()
@@ -23,6 +26,60 @@ static inline void registerDToolTipMetaType()
 Q_CONSTRUCTOR_FUNCTION(registerDToolTipMetaType);
 
 static Qt::TextFormat textFormat = Qt::TextFormat::AutoText;
+
+struct WrapKey
+{
+    QString text;
+    QString font;
+    int width;
+    int wrapMode;
+    int alignment;
+    int direction;
+    int flags;
+
+    bool operator==(const WrapKey &other) const
+    {
+        return width == other.width && wrapMode == other.wrapMode && alignment == other.alignment
+                && direction == other.direction && flags == other.flags
+                && font == other.font && text == other.text;
+    }
+};
+
+static inline uint qHash(const WrapKey &key, uint seed = 0)
+{
+    return ::qHash(key.text, seed) ^ ::qHash(key.font, seed) ^ ::qHash(key.width, seed)
+            ^ ::qHash((key.wrapMode << 24) ^ (key.direction << 20) ^ (key.flags << 8) ^ key.alignment, seed);
+}
+
+// 换行结果只与文本、字体、宽度和 QTextOption 有关，绘制时会反复用到
+typedef QCache<WrapKey, QString> WrapCache;
+Q_GLOBAL_STATIC_WITH_ARGS(WrapCache, wrapCache, (256))
+
+// 延迟换行：在 ToolTip 事件到来时才计算
+class LazyWrapFilter : public QObject
+{
+public:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::ToolTip && watched->isWidgetType()) {
+            QWidget *widget = static_cast<QWidget *>(watched);
+            const QVariant &text = widget->property("_d_dtk_toolTipWrapText");
+
+            // 若之后又被设置了其他 ToolTip 则不再处理
+            if (text.isValid() && widget->toolTip() == text.toString()) {
+                const QTextOption &option = qvariant_cast<QTextOption>(widget->property("_d_dtk_toolTipWrapOption"));
+                widget->setToolTip(DToolTip::wrapToolTipText(text.toString(), option));
+            }
+
+            widget->setProperty("_d_dtk_toolTipWrapText", QVariant());
+            widget->setProperty("_d_dtk_toolTipWrapOption", QVariant());
+            widget->removeEventFilter(this);
+        }
+
+        return QObject::eventFilter(watched, event);
+    }
+};
+Q_GLOBAL_STATIC(LazyWrapFilter, lazyWrapFilter)
 }
 
 /*!
@@ -91,14 +148,35 @@ DToolTip::ToolTipShowMode DToolTip::toolTipShowMode(const QWidget *widget)
     }
 }
 
+/*!
+@~english
+  @brief Wrap \a text at the tooltip label width using \a option.
+
+  Results are kept in a bounded cache keyed on the text, the tooltip font,
+  the maximum width and the text option, so repeated calls from paint
+  events do not lay the text out again.
+ */
 QString DToolTip::wrapToolTipText(QString text, QTextOption option)
 {
     if (text.isEmpty()) {
         return "";
     }
     const auto MaxPixelsPerRow = DStyle::pixelMetric(nullptr, DStyle::PixelMetric::PM_ToolTipLabelWidth);
-    QStringList paragraphs = text.split('\n');
     const QFont &toolTipFont = QToolTip::font();
+    const DToolTipStatic::WrapKey key {
+        text,
+        toolTipFont.key(),
+        MaxPixelsPerRow,
+        option.wrapMode(),
+        int(option.alignment()),
+        option.textDirection(),
+        int(option.flags())
+    };
+    if (const QString *cached = DToolTipStatic::wrapCache->object(key)) {
+        return *cached;
+    }
+
+    QStringList paragraphs = text.split('\n');
     QString toolTip{""};
     for (const QString &paragraph : qAsConst(paragraphs))
     {
@@ -128,9 +206,34 @@ QString DToolTip::wrapToolTipText(QString text, QTextOption option)
         }
     }
     toolTip.chop(1);
+    DToolTipStatic::wrapCache->insert(key, new QString(toolTip));
     return toolTip;
 }
 
+/*!
+@~english
+  @brief Set \a text as the tooltip of \a widget and wrap it only when it is about to be shown.
+
+  The unwrapped text is used as the tooltip until the widget receives a QEvent::ToolTip,
+  then it is replaced by wrapToolTipText(\a text, \a option). Setting another tooltip
+  on the widget in between cancels the wrapping.
+ */
+void DToolTip::setWrappedToolTip(QWidget *widget, const QString &text, const QTextOption &option)
+{
+    widget->setToolTip(text);
+
+    if (text.isEmpty()) {
+        widget->setProperty("_d_dtk_toolTipWrapText", QVariant());
+        widget->setProperty("_d_dtk_toolTipWrapOption", QVariant());
+        widget->removeEventFilter(DToolTipStatic::lazyWrapFilter);
+        return;
+    }
+
+    widget->setProperty("_d_dtk_toolTipWrapText", text);
+    widget->setProperty("_d_dtk_toolTipWrapOption", QVariant::fromValue(option));
+    widget->installEventFilter(DToolTipStatic::lazyWrapFilter);
+}
+
 bool DToolTip::needUpdateToolTip(const QWidget *widget, bool showToolTip)
 {
     QVariant vShowToolTip = widget->property("_d_dtk_showToolTip");
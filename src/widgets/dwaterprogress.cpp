@@ -10,6 +10,7 @@
 #include <QPainterPath>
 #include <QGraphicsDropShadowEffect>
 #include <QEvent>
+#include <QPaintEvent>
 #include <QIcon>
 #include <QLinearGradient>
 
@@ -43,12 +44,24 @@ public:
     }
 
     void resizePixmap(QSize sz);
+    void updateStaticLayers(const QSize &sz);
+    void updateTextLayer(const QSize &sz);
+    void clearCache();
+    QRect waveRect() const;
+    bool isOccluded() const;
     void initUI();
     void setValue(int v);
-    void paint(QPainter *p);
+    void paint(QPainter *p, const QRect &dirtyRect);
 
     QImage waterFrontImage;
     QImage waterBackImage;
+    // static layers, cached per device size, cleared on palette or font change.
+    QImage backgroundImage;
+    QImage maskImage;
+    QImage textImage;
+    QString textImageText;
+    // reused for every animation frame
+    QImage frameImage;
     QString progressText;
     QTimer *timer = Q_NULLPTR;
     QList<Pop> pops;
@@ -150,19 +163,18 @@ void DWaterProgress::setTextVisible(bool visible)
     d->textVisible = visible;
 }
 
-void DWaterProgress::paintEvent(QPaintEvent *)
+void DWaterProgress::paintEvent(QPaintEvent *e)
 {
     D_D(DWaterProgress);
     QPainter p(this);
-    d->paint(&p);
+    d->paint(&p, e->rect());
 }
 
 void DWaterProgress::changeEvent(QEvent *e)
 {
-    if (e->type() == QEvent::PaletteChange) {
+    if (e->type() == QEvent::PaletteChange || e->type() == QEvent::FontChange) {
         D_D(DWaterProgress);
-        d->waterBackImage = QImage();
-        d->waterFrontImage = QImage();
+        d->clearCache();
     }
 
     return QWidget::changeEvent(e);
@@ -193,6 +205,138 @@ void DWaterProgressPrivate::resizePixmap(QSize sz)
     }
 }
 
+void DWaterProgressPrivate::updateStaticLayers(const QSize &sz)
+{
+    if (backgroundImage.size() == sz)
+        return;
+
+    QPointF pointStart(sz.width() / 2, 0);
+    QPointF pointEnd(sz.width() / 2, sz.height());
+    QLinearGradient linear(pointStart, pointEnd);
+    QColor startColor("#1F08FF");
+    startColor.setAlphaF(1);
+    QColor endColor("#50FFF7");
+    endColor.setAlphaF(0.28);
+    linear.setColorAt(0, startColor);
+    linear.setColorAt(1, endColor);
+    linear.setSpread(QGradient::PadSpread);
+
+    backgroundImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    backgroundImage.fill(Qt::transparent);
+    QPainter backgroundPainter(&backgroundImage);
+    backgroundPainter.setRenderHint(QPainter::Antialiasing);
+    backgroundPainter.setPen(Qt::NoPen);
+    backgroundPainter.setBrush(linear);
+    backgroundPainter.drawEllipse(backgroundImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    backgroundPainter.end();
+
+    maskImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    maskImage.fill(Qt::transparent);
+    QPainterPath path;
+    path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
+    QPainter maskPainter(&maskImage);
+    maskPainter.setRenderHint(QPainter::Antialiasing);
+    maskPainter.setPen(QPen(Qt::white, 1));
+    maskPainter.fillPath(path, QBrush(Qt::white));
+    maskPainter.end();
+
+    textImage = QImage();
+}
+
+void DWaterProgressPrivate::updateTextLayer(const QSize &sz)
+{
+    if (textImage.size() == sz && textImageText == progressText)
+        return;
+
+    textImageText = progressText;
+    textImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+    textImage.fill(Qt::transparent);
+
+    QRectF rect(QPointF(0, 0), sz);
+    QPainter textPainter(&textImage);
+    textPainter.setRenderHint(QPainter::Antialiasing);
+    auto font = textPainter.font();
+
+    QRect rectValue;
+    QSize fontTextSize;
+    int actual_width;
+    int actual_height;
+    if (progressText == "100") {
+        font.setPixelSize(sz.height() * 35 / 100);
+        textPainter.setFont(font);
+
+        fontTextSize = QFontMetrics(font).size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
+        int design_width = sz.width() * 60 / 100;
+        int design_height = sz.height() * 35 / 100;
+        actual_width = qMax(fontTextSize.width(), design_width);
+        actual_height = qMax(fontTextSize.height(), design_height);
+
+        rectValue.setWidth(actual_width);
+        rectValue.setHeight(actual_height);
+        rectValue.moveCenter(rect.center().toPoint());
+        textPainter.setPen(Qt::white);
+        textPainter.drawText(rectValue, Qt::AlignCenter, progressText);
+
+    } else {
+        font.setPixelSize(sz.height() * 40 / 100);
+        textPainter.setFont(font);
+
+        QFontMetrics numberFontMetrics(font);
+        fontTextSize = numberFontMetrics.size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
+        int design_width = sz.width() * 45 / 100;
+        int design_height = sz.height() * 40 / 100;
+        actual_width = qMax(fontTextSize.width(), design_width);
+        actual_height = qMax(fontTextSize.height(), design_height);
+
+        rectValue.setWidth(actual_width);
+        rectValue.setHeight(actual_height);
+        rectValue.moveCenter(rect.center().toPoint());
+        rectValue.moveLeft(rect.left() + rect.width() * 0.45 * 0.5);
+
+        textPainter.setPen(Qt::white);
+        textPainter.drawText(rectValue, Qt::AlignCenter, progressText);
+        font.setPixelSize(font.pixelSize() / 2);
+        textPainter.setFont(font);
+
+        QFontMetrics ratioFontMetrics(font);
+        design_height = rect.height() * 20 / 100;
+        actual_height = qMax(ratioFontMetrics.height(), design_height);
+        int descent_diff = numberFontMetrics.descent() - ratioFontMetrics.descent();
+
+        QRect rectPerent(QPoint(rectValue.right(), rectValue.bottom() - descent_diff - actual_height),
+                         QPoint(rectValue.right() + rect.width() * 20 / 100, rectValue.bottom() - descent_diff));
+
+        textPainter.drawText(rectPerent, Qt::AlignCenter, "%");
+    }
+}
+
+void DWaterProgressPrivate::clearCache()
+{
+    waterBackImage = QImage();
+    waterFrontImage = QImage();
+    backgroundImage = QImage();
+    maskImage = QImage();
+    textImage = QImage();
+}
+
+/*!
+  \internal
+  The part of the widget covered by the moving waves and pops, everything
+  above the water surface stays the same between animation frames.
+ */
+QRect DWaterProgressPrivate::waveRect() const
+{
+    D_QC(DWaterProgress);
+    int top = (100 - value - 10) * q->height() / 100 - 1;
+    return q->rect().adjusted(0, qMax(0, top), 0, 0);
+}
+
+bool DWaterProgressPrivate::isOccluded() const
+{
+    D_QC(DWaterProgress);
+    return !q->isVisible() || q->window()->isMinimized() || q->visibleRegion().isEmpty();
+}
+
 void DWaterProgressPrivate::initUI()
 {
     D_Q(DWaterProgress);
@@ -245,48 +389,52 @@ void DWaterProgressPrivate::initUI()
             }
             pop.xOffset = qSin((pop.yOffset / 100) * 2 * 3.14) * 18 * pop.xSpeed + 50;
         }
-        q->update();
+
+        // keep the animation state going, but don't paint frames nobody can see.
+        if (isOccluded())
+            return;
+
+        q->update(waveRect());
     });
 }
 
 void DWaterProgressPrivate::setValue(int v)
 {
+    D_Q(DWaterProgress);
     value = v;
     progressText = QString("%1").arg(v);
+    // the water level moved, the animation only repaints below it.
+    q->update();
 }
 
-void DWaterProgressPrivate::paint(QPainter *p)
+void DWaterProgressPrivate::paint(QPainter *p, const QRect &dirtyRect)
 {
     D_Q(DWaterProgress);
     p->setRenderHint(QPainter::Antialiasing);
 
     qreal pixelRatio = q->devicePixelRatioF();
-    QRectF rect = QRectF(0, 0, q->width() * pixelRatio, q->height() * pixelRatio);
     QSize sz = QSizeF(q->width() * pixelRatio, q->height() * pixelRatio).toSize();
 
     resizePixmap(sz);
+    updateStaticLayers(sz);
+    if (textVisible)
+        updateTextLayer(sz);
 
-    int yOffset = rect.toRect().topLeft().y() + (100 - value - 10)  * sz.height() / 100;
+    if (frameImage.size() != sz)
+        frameImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
+
+    int yOffset = (100 - value - 10)  * sz.height() / 100;
+    // only recompose the pixels of the area that actually needs a repaint.
+    const QRect deviceDirtyRect = QRectF(dirtyRect.x() * pixelRatio, dirtyRect.y() * pixelRatio,
+                                         dirtyRect.width() * pixelRatio, dirtyRect.height() * pixelRatio)
+                                      .toAlignedRect() & frameImage.rect();
 
     // draw water
-    QImage waterImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
-    QPainter waterPinter(&waterImage);
+    QPainter waterPinter(&frameImage);
+    waterPinter.setClipRect(deviceDirtyRect);
     waterPinter.setRenderHint(QPainter::Antialiasing);
     waterPinter.setCompositionMode(QPainter::CompositionMode_Source);
-
-    QPointF pointStart(sz.width() / 2, 0);
-    QPointF pointEnd(sz.width() / 2, sz.height());
-    QLinearGradient linear(pointStart, pointEnd);
-    QColor startColor("#1F08FF");
-    startColor.setAlphaF(1);
-    QColor endColor("#50FFF7");
-    endColor.setAlphaF(0.28);
-    linear.setColorAt(0, startColor);
-    linear.setColorAt(1, endColor);
-    linear.setSpread(QGradient::PadSpread);
-    waterPinter.setPen(Qt::NoPen);
-    waterPinter.setBrush(linear);
-    waterPinter.drawEllipse(waterImage.rect().center(), sz.width() / 2 + 1, sz.height() / 2  + 1);
+    waterPinter.drawImage(0, 0, backgroundImage);
 
     waterPinter.setCompositionMode(QPainter::CompositionMode_SourceOver);
     waterPinter.drawImage(static_cast<int>(backXOffset), yOffset, waterBackImage);
@@ -296,95 +444,24 @@ void DWaterProgressPrivate::paint(QPainter *p)
 
     //drwa pop
     if (value > 30) {
+        QColor color(255, 255, 255, 255 * 0.3);
+        waterPinter.setPen(Qt::NoPen);
+        waterPinter.setBrush(color);
         for (auto &pop : pops) {
-            QPainterPath popPath;
-            popPath.addEllipse(pop.xOffset * sz.width() / 100, (100 - pop.yOffset) * sz.height() / 100,
-                               pop.size * sz.width() / 100, pop.size * sz.height() / 100);
-            QColor color(255, 255, 255, 255 * 0.3);
-            waterPinter.fillPath(popPath, color);
+            waterPinter.drawEllipse(QRectF(pop.xOffset * sz.width() / 100, (100 - pop.yOffset) * sz.height() / 100,
+                                           pop.size * sz.width() / 100, pop.size * sz.height() / 100));
         }
     }
 
-    if (textVisible) {
-        auto font = waterPinter.font();
-
-        QRect rectValue;
-        QSize fontTextSize;
-        int actual_width;
-        int actual_height;
-        if (progressText == "100") {
-            font.setPixelSize(sz.height() * 35 / 100);
-            waterPinter.setFont(font);
-
-            fontTextSize = QFontMetrics(font).size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
-            int design_width = sz.width() * 60 / 100;
-            int design_height = sz.height() * 35 / 100;
-            actual_width = qMax(fontTextSize.width(), design_width);
-            actual_height = qMax(fontTextSize.height(), design_height);
-
-            rectValue.setWidth(actual_width);
-            rectValue.setHeight(actual_height);
-            rectValue.moveCenter(rect.center().toPoint());
-            waterPinter.setPen(Qt::white);
-            waterPinter.drawText(rectValue, Qt::AlignCenter, progressText);
-
-        } else {
-            font.setPixelSize(sz.height() * 40 / 100);
-            waterPinter.setFont(font);
-
-            QFontMetrics numberFontMetrics(font);
-            fontTextSize = numberFontMetrics.size(Qt::TextSingleLine | Qt::AlignCenter, progressText);
-            int design_width = sz.width() * 45 / 100;
-            int design_height = sz.height() * 40 / 100;
-            actual_width = qMax(fontTextSize.width(), design_width);
-            actual_height = qMax(fontTextSize.height(), design_height);
-
-            rectValue.setWidth(actual_width);
-            rectValue.setHeight(actual_height);
-            rectValue.moveCenter(rect.center().toPoint());
-            rectValue.moveLeft(rect.left() + rect.width() * 0.45 * 0.5);
-
-            waterPinter.setPen(Qt::white);
-            waterPinter.drawText(rectValue, Qt::AlignCenter, progressText);
-            font.setPixelSize(font.pixelSize() / 2);
-            waterPinter.setFont(font);
-
-            QFontMetrics ratioFontMetrics(font);
-            design_height = rect.height() * 20 / 100;
-            actual_height = qMax(ratioFontMetrics.height(), design_height);
-            int descent_diff = numberFontMetrics.descent() - ratioFontMetrics.descent();
-
-            QRect rectPerent(QPoint(rectValue.right(), rectValue.bottom() - descent_diff - actual_height),
-                             QPoint(rectValue.right() + rect.width() * 20 / 100, rectValue.bottom() - descent_diff));
-
-            waterPinter.drawText(rectPerent, Qt::AlignCenter, "%");
-        }
-    }
-    waterPinter.end();
+    if (textVisible)
+        waterPinter.drawImage(0, 0, textImage);
 
-    QPixmap maskPixmap(sz);
-    maskPixmap.fill(Qt::transparent);
-    QPainterPath path;
-    path.addEllipse(QRectF(0, 0, sz.width(), sz.height()));
-    QPainter maskPainter(&maskPixmap);
-    maskPainter.setRenderHint(QPainter::Antialiasing);
-    maskPainter.setPen(QPen(Qt::white, 1));
-    maskPainter.fillPath(path, QBrush(Qt::white));
+    // clip the content to the circle
+    waterPinter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    waterPinter.drawImage(0, 0, maskImage);
+    waterPinter.end();
 
-    QPainter::CompositionMode mode = QPainter::CompositionMode_SourceIn;
-    QImage contentImage = QImage(sz, QImage::Format_ARGB32_Premultiplied);
-    QPainter contentPainter(&contentImage);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_Source);
-    contentPainter.fillRect(contentImage.rect(), Qt::transparent);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    contentPainter.drawImage(0, 0, maskPixmap.toImage());
-    contentPainter.setCompositionMode(mode);
-    contentPainter.drawImage(0, 0, waterImage);
-    contentPainter.setCompositionMode(QPainter::CompositionMode_DestinationOver);
-    contentPainter.end();
-
-    contentImage.setDevicePixelRatio(pixelRatio);
-    p->drawImage(q->rect(), contentImage);
+    p->drawImage(q->rect(), frameImage);
 }
 
 DWIDGET_END_NAMESPACE
@@ -12,6 +12,7 @@
 
 #include <QIcon>
 #include <QPointer>
+#include <QHash>
 
 class QLocalServer;
 class QTranslator;
@@ -51,6 +52,9 @@ public:
     void _q_resizeWindowContentsForVirtualKeyboard();
     void _q_sizeModeChanged();
     void handleSizeModeChangeEvent(QWidget *widget, QEvent *event);
+    void handlePendingSizeModeChange(QWidget *widget);
+    void addPendingSizeModeWidget(QWidget *widget);
+    bool takePendingSizeModeWidget(QWidget *widget);
 
     static bool isUserManualExists();
 public:
@@ -88,6 +92,9 @@ public:
     QPair<int, int> lastContentsMargins;
     QMargins activeInputWindowContentsMargins;
     QList<QWidget*> acclimatizeVirtualKeyboardWindows;
+    // 尺寸模式变化时未显示、尚未更新的控件，控件销毁时通过 destroyed 连接移除，
+    // 避免记录无效指针以及地址被新控件复用时误发 StyleChange
+    QHash<QWidget*, QMetaObject::Connection> pendingSizeModeWidgets;
 };
 
 DWIDGET_END_NAMESPACE
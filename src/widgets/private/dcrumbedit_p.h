@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DCRUMBEDIT_P_H
+#define DCRUMBEDIT_P_H
+
+#include "dcrumbedit.h"
+
+#include <QHash>
+#include <QPainterPath>
+#include <QStaticText>
+#include <QTextObjectInterface>
+
+DWIDGET_BEGIN_NAMESPACE
+
+class CrumbObjectInterface : public QObject, public QTextObjectInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(QTextObjectInterface)
+
+public:
+    enum TextMargin
+    {
+        TopMargin = 2,
+        LeftMargin = 4,
+    };
+
+    explicit CrumbObjectInterface(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+    QSizeF intrinsicSize(QTextDocument *doc, int posInDocument,
+                         const QTextFormat &format) Q_DECL_OVERRIDE;
+
+    void drawObject(QPainter *painter, const QRectF &rect, QTextDocument *doc,
+                    int posInDocument, const QTextFormat &format) Q_DECL_OVERRIDE;
+
+    QBrush backgroundBrush(const QRect &rect, const QBrush &brush);
+
+private:
+    // 每个 crumb 的尺寸、文本排版和背景路径，只在文本、字体、圆角或大小变化时重建
+    struct CrumbGeometry {
+        QSizeF size;
+        qreal fontHeight = 0;
+        QSize rectSize;
+        QPainterPath backgroundPath;
+        QPainterPath tagPath;
+        QStaticText text;
+        QPointF textPos;
+    };
+
+    CrumbGeometry &geometry(const DCrumbTextFormat &format, const QFont &font);
+
+    QHash<QString, CrumbGeometry> geometries;
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DCRUMBEDIT_P_H
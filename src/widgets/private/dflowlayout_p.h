@@ -23,6 +23,8 @@ class DFlowLayoutPrivate : public DTK_CORE_NAMESPACE::DObjectPrivate
     int horizontalSpacing = 0;
     int verticalSpacing = 0;
     mutable QSize sizeHint;
+    mutable int hfwWidth = -1;
+    mutable int hfwHeight = -1;
     DFlowLayout::Flow flow = DFlowLayout::Flow::LeftToRight;
 
     D_DECLARE_PUBLIC(DFlowLayout)
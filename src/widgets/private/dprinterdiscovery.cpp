@@ -0,0 +1,335 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "dprinterdiscovery_p.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileSystemWatcher>
+#include <QLibrary>
+#include <QPointer>
+#include <QPrinterInfo>
+#include <QtConcurrent>
+#include <private/qprintdevice_p.h>
+#include <qpa/qplatformprintplugin.h>
+#include <qpa/qplatformprintersupport.h>
+
+#include <cups/cups.h>
+#include <cups/ppd.h>
+
+#include <unistd.h>
+
+DWIDGET_BEGIN_NAMESPACE
+
+// cupsd 修改打印机列表时会替换该目录下的 printers.conf，更换驱动时会替换 ppd 目录下的文件
+static const char *CupsConfigDir = "/etc/cups";
+static const char *CupsPpdDir = "/etc/cups/ppd";
+
+// libcups 只加载一次，不再卸载
+static QLibrary *cupsLibrary()
+{
+    static QLibrary *library = [] {
+        QLibrary *library = new QLibrary("cups", "2");
+        if (!library->load())
+            qWarning() << "Cups not found";
+        return library;
+    }();
+
+    return library->isLoaded() ? library : nullptr;
+}
+
+template<typename Function>
+static bool resolveCupsFunction(QLibrary *library, const char *symbol, Function &function)
+{
+    function = reinterpret_cast<Function>(library->resolve(symbol));
+    if (!function)
+        qWarning() << symbol << "function load failed.";
+
+    return function;
+}
+
+// 从打印机的 ppd 文件中读取第一个非灰度的 ColorModel 选项
+static QByteArray colorModelFromPpd(const QString &printerName)
+{
+    QLibrary *library = cupsLibrary();
+    if (!library)
+        return {};
+
+    cups_dest_t *(*cupsGetNamedDest)(http_t * http, const char *name, const char *instance) = nullptr;
+    void (*cupsFreeDests)(int num_dests, cups_dest_t *dests) = nullptr;
+    const char *(*cupsGetPPD)(const char *name) = nullptr;
+    ppd_file_t *(*ppdOpenFile)(const char *filename) = nullptr;
+    void (*ppdClose)(ppd_file_t * ppd) = nullptr;
+    void (*ppdMarkDefaults)(ppd_file_t * ppd) = nullptr;
+    int (*cupsMarkOptions)(ppd_file_t * ppd, int num_options, cups_option_t *options) = nullptr;
+    int (*ppdLocalize)(ppd_file_t * ppd) = nullptr;
+    ppd_option_t *(*ppdFindOption)(ppd_file_t * ppd, const char *keyword) = nullptr;
+
+    if (!resolveCupsFunction(library, "cupsGetNamedDest", cupsGetNamedDest)
+            || !resolveCupsFunction(library, "cupsFreeDests", cupsFreeDests)
+            || !resolveCupsFunction(library, "cupsGetPPD", cupsGetPPD)
+            || !resolveCupsFunction(library, "ppdOpenFile", ppdOpenFile)
+            || !resolveCupsFunction(library, "ppdClose", ppdClose)
+            || !resolveCupsFunction(library, "ppdMarkDefaults", ppdMarkDefaults)
+            || !resolveCupsFunction(library, "cupsMarkOptions", cupsMarkOptions)
+            || !resolveCupsFunction(library, "ppdLocalize", ppdLocalize)
+            || !resolveCupsFunction(library, "ppdFindOption", ppdFindOption)) {
+        return {};
+    }
+
+    const auto parts = printerName.split(QLatin1Char('/'));
+    const QByteArray originalName = parts.at(0).toLocal8Bit();
+    QByteArray instance;
+    if (parts.size() > 1)
+        instance = parts.at(1).toUtf8();
+
+    // 根据打印机名称获取cup实例 用于读取ppd文件
+    cups_dest_t *dest = cupsGetNamedDest(CUPS_HTTP_DEFAULT, originalName, instance.isNull() ? nullptr : instance.constData());
+    if (!dest)
+        return {};
+
+    QByteArray colorModel;
+    ppd_file_t *ppd = nullptr;
+    if (const char *ppdFile = cupsGetPPD(originalName)) {
+        ppd = ppdOpenFile(ppdFile);
+        unlink(ppdFile);
+    }
+
+    if (ppd) {
+        ppdMarkDefaults(ppd);
+        cupsMarkOptions(ppd, dest->num_options, dest->options);
+        ppdLocalize(ppd);
+
+        // 从ppd文件中找到对应属性
+        if (ppd_option_t *option = ppdFindOption(ppd, "ColorModel")) {
+            for (int i = 0; i < option->num_choices; ++i) {
+                const ppd_choice_t *choice = option->choices + i;
+                if (!QByteArray(choice->choice).toLower().startsWith("gray")) {
+                    colorModel = choice->choice;
+                    break;
+                }
+            }
+        }
+
+        ppdClose(ppd);
+    }
+
+    cupsFreeDests(1, dest);
+    return colorModel;
+}
+
+/*!
+  \internal
+  \brief 进程内共享的打印机列表.
+
+  打印机在工作线程中枚举，结果缓存在进程内，CUPS 配置变化时（inotify）自动刷新，
+  列表的变化通过 printerAdded 和 printerRemoved 通知。
+
+  每台打印机的能力（纸张、颜色、双面、分辨率和 ppd 中的 ColorModel）同样在工作线程中
+  读取并缓存，读取完成后发出 capabilitiesReady，打印机被移除或 CUPS 配置变化时失效。
+  所有查询都不会阻塞调用者所在的线程。
+
+  实例随 QCoreApplication 一起销毁，重新创建应用后再次调用时会重新创建。
+ */
+DPrinterDiscovery *DPrinterDiscovery::instance()
+{
+    static QPointer<DPrinterDiscovery> discovery;
+    if (!discovery) {
+        discovery = new DPrinterDiscovery(qApp);
+        discovery->refresh();
+    }
+
+    return discovery;
+}
+
+DPrinterDiscovery::DPrinterDiscovery(QObject *parent)
+    : QObject(parent)
+    , m_discover(&DPrinterDiscovery::discoverPrinters)
+    , m_loadCapabilities(&DPrinterDiscovery::loadCapabilities)
+    , m_configWatcher(new QFileSystemWatcher(this))
+    , m_ready(false)
+    , m_refreshPending(false)
+    , m_capabilitiesStale(false)
+{
+    // 在主线程中加载打印插件，工作线程只使用已创建的实例
+    QPlatformPrinterSupportPlugin::get();
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(500);
+
+    connect(&m_refreshTimer, &QTimer::timeout, this, &DPrinterDiscovery::refresh);
+    connect(&m_watcher, &QFutureWatcher<DPrinterDiscoveryResult>::finished, this, &DPrinterDiscovery::onDiscoveryFinished);
+
+    m_configWatcher->addPaths({CupsConfigDir, CupsPpdDir});
+    connect(m_configWatcher, &QFileSystemWatcher::directoryChanged, this, &DPrinterDiscovery::onConfigChanged);
+}
+
+bool DPrinterDiscovery::isReady() const
+{
+    return m_ready;
+}
+
+QStringList DPrinterDiscovery::printerNames() const
+{
+    return m_printerNames;
+}
+
+QString DPrinterDiscovery::defaultPrinterName() const
+{
+    return m_defaultPrinterName;
+}
+
+bool DPrinterDiscovery::contains(const QString &printerName) const
+{
+    return m_printerNames.contains(printerName);
+}
+
+/*!
+  \internal
+  \brief 返回打印机 \a printerName 的能力.
+
+  已缓存时直接返回；否则在后台读取，返回 loaded 为 false 的空结果，
+  读取完成后发出 capabilitiesReady。
+ */
+DPrinterCapabilities DPrinterDiscovery::capabilities(const QString &printerName)
+{
+    auto it = m_capabilities.constFind(printerName);
+    if (it != m_capabilities.constEnd())
+        return it.value();
+
+    preloadCapabilities(printerName);
+    return DPrinterCapabilities();
+}
+
+/*!
+  \internal
+  \brief 在后台读取打印机 \a printerName 的能力，已缓存或正在读取时忽略.
+ */
+void DPrinterDiscovery::preloadCapabilities(const QString &printerName)
+{
+    if (printerName.isEmpty() || m_capabilities.contains(printerName) || m_pendingCapabilities.contains(printerName))
+        return;
+
+    auto watcher = new QFutureWatcher<DPrinterCapabilities>(this);
+    connect(watcher, &QFutureWatcher<DPrinterCapabilities>::finished, this, [this, printerName, watcher] {
+        onCapabilitiesLoaded(printerName, watcher);
+    });
+
+    m_pendingCapabilities.insert(printerName, watcher);
+    watcher->setFuture(QtConcurrent::run([loader = m_loadCapabilities, printerName] {
+        DPrinterCapabilities capabilities = loader(printerName);
+        capabilities.loaded = true;
+        return capabilities;
+    }));
+}
+
+void DPrinterDiscovery::onCapabilitiesLoaded(const QString &printerName, QFutureWatcher<DPrinterCapabilities> *watcher)
+{
+    watcher->deleteLater();
+
+    // 读取期间打印机被移除或配置发生变化，结果已经过期
+    if (m_pendingCapabilities.value(printerName) != watcher)
+        return;
+
+    m_pendingCapabilities.remove(printerName);
+    m_capabilities.insert(printerName, watcher->result());
+    Q_EMIT capabilitiesReady(printerName);
+}
+
+// 丢弃缓存和正在进行的读取，工作线程中的任务结束后结果被忽略
+void DPrinterDiscovery::dropCapabilities(const QString &printerName)
+{
+    m_capabilities.remove(printerName);
+
+    if (QFutureWatcher<DPrinterCapabilities> *watcher = m_pendingCapabilities.take(printerName))
+        watcher->deleteLater();
+}
+
+DPrinterDiscoveryResult DPrinterDiscovery::discoverPrinters()
+{
+    DPrinterDiscoveryResult result;
+    result.printerNames = QPrinterInfo::availablePrinterNames();
+    result.defaultPrinterName = QPrinterInfo::defaultPrinterName();
+    return result;
+}
+
+DPrinterCapabilities DPrinterDiscovery::loadCapabilities(const QString &printerName)
+{
+    DPrinterCapabilities capabilities;
+
+    if (QPlatformPrinterSupport *ps = QPlatformPrinterSupportPlugin::get()) {
+        const QPrintDevice device = ps->createPrintDevice(printerName);
+        if (device.isValid()) {
+            capabilities.pageSizes = device.supportedPageSizes();
+            capabilities.colorModes = device.supportedColorModes();
+            capabilities.resolutions = device.supportedResolutions();
+            for (QPrint::DuplexMode mode : device.supportedDuplexModes())
+                capabilities.duplexModes.append(QPrinter::DuplexMode(mode));
+        }
+    }
+
+    capabilities.cupsColorModel = colorModelFromPpd(printerName);
+    return capabilities;
+}
+
+/*!
+  \internal
+  \brief 在后台重新枚举打印机，正在枚举时合并到下一次.
+ */
+void DPrinterDiscovery::refresh()
+{
+    if (m_watcher.isRunning()) {
+        m_refreshPending = true;
+        return;
+    }
+
+    m_watcher.setFuture(QtConcurrent::run(m_discover));
+}
+
+void DPrinterDiscovery::onConfigChanged()
+{
+    // 驱动或选项可能已改变，下次枚举完成后重新读取所有打印机的能力
+    m_capabilitiesStale = true;
+    m_refreshTimer.start();
+}
+
+void DPrinterDiscovery::onDiscoveryFinished()
+{
+    const DPrinterDiscoveryResult &result = m_watcher.result();
+    const QStringList oldPrinterNames = m_printerNames;
+
+    m_printerNames = result.printerNames;
+    m_defaultPrinterName = result.defaultPrinterName;
+    m_ready = true;
+
+    if (m_capabilitiesStale) {
+        m_capabilitiesStale = false;
+        for (const QString &printerName : m_capabilities.keys() + m_pendingCapabilities.keys())
+            dropCapabilities(printerName);
+    }
+
+    for (const QString &printerName : oldPrinterNames) {
+        if (!m_printerNames.contains(printerName)) {
+            dropCapabilities(printerName);
+            Q_EMIT printerRemoved(printerName);
+        }
+    }
+
+    for (const QString &printerName : qAsConst(m_printerNames)) {
+        if (!oldPrinterNames.contains(printerName))
+            Q_EMIT printerAdded(printerName);
+    }
+
+    for (const QString &printerName : qAsConst(m_printerNames))
+        preloadCapabilities(printerName);
+
+    Q_EMIT discovered();
+
+    if (m_refreshPending) {
+        m_refreshPending = false;
+        refresh();
+    }
+}
+
+DWIDGET_END_NAMESPACE
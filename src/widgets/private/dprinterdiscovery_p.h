@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DPRINTERDISCOVERY_P_H
+#define DPRINTERDISCOVERY_P_H
+
+#include <dtkwidget_global.h>
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPageSize>
+#include <QPrinter>
+#include <QStringList>
+#include <QTimer>
+
+#include <functional>
+
+#include <private/qprint_p.h>
+
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+QT_END_NAMESPACE
+
+DWIDGET_BEGIN_NAMESPACE
+
+struct DPrinterDiscoveryResult
+{
+    QStringList printerNames;
+    QString defaultPrinterName;
+};
+
+struct DPrinterCapabilities
+{
+    QList<QPageSize> pageSizes;
+    QList<QPrint::ColorMode> colorModes;
+    QList<QPrinter::DuplexMode> duplexModes;
+    QList<int> resolutions;
+    // ppd 文件中第一个非灰度的 ColorModel 选项
+    QByteArray cupsColorModel;
+    // 为 false 时仍在后台读取，其它成员均为空
+    bool loaded = false;
+
+    bool supportsDuplex(QPrinter::DuplexMode mode) const { return duplexModes.contains(mode); }
+    bool supportsColorMode(QPrint::ColorMode mode) const { return colorModes.contains(mode); }
+};
+
+class DPrinterDiscovery : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DPrinterDiscovery *instance();
+
+    bool isReady() const;
+    QStringList printerNames() const;
+    QString defaultPrinterName() const;
+    bool contains(const QString &printerName) const;
+
+    DPrinterCapabilities capabilities(const QString &printerName);
+    void preloadCapabilities(const QString &printerName);
+
+public Q_SLOTS:
+    void refresh();
+
+Q_SIGNALS:
+    void printerAdded(const QString &printerName);
+    void printerRemoved(const QString &printerName);
+    void discovered();
+    void capabilitiesReady(const QString &printerName);
+
+private:
+    explicit DPrinterDiscovery(QObject *parent = nullptr);
+
+    void onConfigChanged();
+    void onDiscoveryFinished();
+    void onCapabilitiesLoaded(const QString &printerName, QFutureWatcher<DPrinterCapabilities> *watcher);
+    void dropCapabilities(const QString &printerName);
+
+    static DPrinterDiscoveryResult discoverPrinters();
+    static DPrinterCapabilities loadCapabilities(const QString &printerName);
+
+    // 在工作线程中枚举打印机和读取能力，测试时替换为不访问 CUPS 的实现
+    std::function<DPrinterDiscoveryResult()> m_discover;
+    std::function<DPrinterCapabilities(const QString &)> m_loadCapabilities;
+    QFutureWatcher<DPrinterDiscoveryResult> m_watcher;
+    QFileSystemWatcher *m_configWatcher;
+    QTimer m_refreshTimer;
+    QStringList m_printerNames;
+    QString m_defaultPrinterName;
+    QHash<QString, DPrinterCapabilities> m_capabilities;
+    QHash<QString, QFutureWatcher<DPrinterCapabilities> *> m_pendingCapabilities;
+    bool m_ready;
+    bool m_refreshPending;
+    bool m_capabilitiesStale;
+};
+
+DWIDGET_END_NAMESPACE
+
+#endif // DPRINTERDISCOVERY_P_H
@@ -122,6 +122,12 @@ public:
     bool supportedDuplexFlag = false;
     bool supportedColorMode = false;
     bool isInited = false;
+    bool printerSelectedByUser = false;
+    // 首次枚举打印机完成前打印设备列表不可选
+    bool printersDiscovered = false;
+    // 正在后台读取能力的打印机，以及读取前选中的纸张
+    QString capabilitiesPendingPrinter;
+    QString pendingPaperSize;
     int strLengths = 0;
     bool isOnFocus = false;
     QString lastCusWatermarkText = "";
@@ -11,6 +11,9 @@
 #include <QPointer>
 #include <QTimer>
 #include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QCoreApplication>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -33,17 +36,30 @@ static const QString SettingsCount(u8"count");
 static const QString SettingsSpacingSize(u8"spacingSize");
 static const QString SettingsSpacerId(u8"builtin/spacer");
 static const QString SettingsStretchId(u8"builtin/stretch");
+// 编辑面板中连续的修改合并为一次写入
+static const int SaveDelay = 300;
 
 DTitlebarDataStore::DTitlebarDataStore(QObject *parent)
     : QObject(parent)
     , m_settingsGroupName("dtitlebar-settings")
     , m_settingsGroupNameSubGroup(QString("%1/%2").arg(m_settingsGroupName))
+    , m_metaFileWatcher(new QFileSystemWatcher(this))
+    , m_saveTimer(new QTimer(this))
 {
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SaveDelay);
+    connect(m_saveTimer, &QTimer::timeout, this, &DTitlebarDataStore::savePositionsToCache);
+    connect(m_metaFileWatcher, &QFileSystemWatcher::fileChanged, this, &DTitlebarDataStore::onMetaFileChanged);
+
+    // instance() 创建的对象不会被析构，退出前写入尚未保存的修改
+    if (QCoreApplication::instance())
+        connect(qApp, &QCoreApplication::aboutToQuit, this, &DTitlebarDataStore::flushPendingSave);
 }
 
 DTitlebarDataStore::~DTitlebarDataStore()
 {
     save();
+    flushPendingSave();
     qDeleteAll(m_instances);
 }
 
@@ -117,19 +133,25 @@ ToolInstance *DTitlebarDataStore::getInstance(const QString &key) const
 
 bool DTitlebarDataStore::load(const QString &path)
 {
-    m_filePath = path;
+    if (m_filePath != path) {
+        m_filePath = path;
+        m_metaRoot = QJsonObject();
+        m_metaRootLoaded = false;
+        watchMetaFile();
+    }
     return load();
 }
 
 void DTitlebarDataStore::save()
 {
     if (m_isValid) {
-        savePositionsToCache();
+        m_saveTimer->start();
     }
 }
 
 void DTitlebarDataStore::clear()
 {
+    m_saveTimer->stop();
     clearCache();
     qDeleteAll(m_instances);
     m_instances.clear();
@@ -380,6 +402,16 @@ QStringList DTitlebarDataStore::positionsFromToolMeta() const
 }
 
 QJsonObject DTitlebarDataStore::metaRoot() const
+{
+    // 描述文件只在首次使用或外部修改后解析
+    if (!m_metaRootLoaded) {
+        m_metaRoot = readMetaRoot();
+        m_metaRootLoaded = true;
+    }
+    return m_metaRoot;
+}
+
+QJsonObject DTitlebarDataStore::readMetaRoot() const
 {
     QFile file(m_filePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -398,6 +430,32 @@ QJsonObject DTitlebarDataStore::metaRoot() const
     return document.object();
 }
 
+void DTitlebarDataStore::watchMetaFile()
+{
+    const QStringList files = m_metaFileWatcher->files();
+    if (!files.isEmpty())
+        m_metaFileWatcher->removePaths(files);
+
+    // 资源文件不会改变，无需监听
+    if (m_filePath.startsWith(QLatin1Char(':')) || !QFileInfo::exists(m_filePath))
+        return;
+
+    m_metaFileWatcher->addPath(m_filePath);
+}
+
+void DTitlebarDataStore::onMetaFileChanged()
+{
+    m_metaRoot = QJsonObject();
+    m_metaRootLoaded = false;
+
+    const auto root = metaRoot();
+    if (root.contains(SettingsSpacingSize))
+        m_spacingSize = root[SettingsSpacingSize].toInt();
+
+    // 以替换方式保存的文件会从监听列表中移除，需要重新添加
+    watchMetaFile();
+}
+
 QVariantList DTitlebarDataStore::positionsFromCache()
 {
     QVariantList positions;
@@ -429,6 +487,15 @@ void DTitlebarDataStore::savePositionsToCache()
     settings.endArray();
 }
 
+void DTitlebarDataStore::flushPendingSave()
+{
+    if (!m_saveTimer->isActive())
+        return;
+
+    m_saveTimer->stop();
+    savePositionsToCache();
+}
+
 void DTitlebarDataStore::clearCache()
 {
     QSettings settings;
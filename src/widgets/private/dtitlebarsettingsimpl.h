@@ -8,11 +8,14 @@
 #include "dtitlebarsettings.h"
 #include <DObjectPrivate>
 #include <DObject>
+#include <QJsonObject>
 #include <QSharedPointer>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QWidget;
+class QFileSystemWatcher;
+class QTimer;
 QT_END_NAMESPACE
 
 DWIDGET_BEGIN_NAMESPACE
@@ -74,8 +77,12 @@ private:
     QString alignmentFromToolMeta(const QJsonObject &root) const;
     QStringList positionsFromToolMeta() const;
     QJsonObject metaRoot() const;
+    QJsonObject readMetaRoot() const;
+    void watchMetaFile();
+    void onMetaFileChanged();
     QVariantList positionsFromCache();
     void savePositionsToCache();
+    void flushPendingSave();
     void clearCache();
     bool acceptCountField(const QString &id) const;
 
@@ -86,6 +93,10 @@ private:
     int m_spacingSize = -1;
     bool m_isValid = false;
     QString m_filePath;
+    mutable QJsonObject m_metaRoot;
+    mutable bool m_metaRootLoaded = false;
+    QFileSystemWatcher *m_metaFileWatcher = nullptr;
+    QTimer *m_saveTimer = nullptr;
 };
 
 struct ToolWrapper
@@ -9,136 +9,117 @@
 #else
 #include <QtGui/private/qtx11extras_p.h>
 #endif
+#include <QCoreApplication>
 #include <QDebug>
 
 #include <X11/X.h>
 #include <X11/XKBlib.h>
-#include <X11/extensions/XInput.h>
-#include <X11/extensions/XInput2.h>
+#include <X11/keysym.h>
 
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 DWIDGET_BEGIN_NAMESPACE
 
-static int xi2_opcode;
+enum LockState {
+    CapslockOn = 0x01,
+    NumlockOn = 0x02
+};
 
-int xinput_version(Display *display)
+// Num Lock 对应的修饰键由键盘映射决定，不一定是 Mod2
+static unsigned int numlockMask(Display *display)
 {
-    XExtensionVersion *version;
-    static int vers = -1;
+    return XkbKeysymToModifiers(display, XK_Num_Lock);
+}
 
-    if (vers != -1)
-        return vers;
+static bool queryLockedMods(Display *display, unsigned int *lockedMods)
+{
+    XkbStateRec state;
+    if (XkbGetState(display, XkbUseCoreKbd, &state) != Success)
+        return false;
 
-    version = XGetExtensionVersion(display, INAME);
+    *lockedMods = state.locked_mods;
+    return true;
+}
 
-    if (version && (version != (XExtensionVersion*) NoSuchExtension)) {
-        vers = version->major_version;
-        XFree(version);
-    }
+int DKeyboardMonitor::listen(Display *display, int xkbEventBase)
+{
+    pollfd fds[2];
+    fds[0].fd = ConnectionNumber(display);
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeupFd;
+    fds[1].events = POLLIN;
 
-    /* Announce our supported version so the server treats us correctly. */
-    if (vers >= XI_2_Major)
+    while (1)
     {
-        const char *forced_version;
-        int maj = 2, min = 2;
-
-        forced_version = getenv("XINPUT_XI2_VERSION");
-        if (forced_version) {
-            if (sscanf(forced_version, "%d.%d", &maj, &min) != 2) {
-                fprintf(stderr, "Invalid format of XINPUT_XI2_VERSION "
-                                "environment variable. Need major.minor\n");
-                exit(1);
+        // 先处理 Xlib 已经读入缓冲区的事件，否则 poll 不会再次返回
+        while (XPending(display)) {
+            XEvent ev;
+            XNextEvent(display, &ev);
+
+            if (ev.type != xkbEventBase)
+                continue;
+
+            const XkbEvent *xkbEvent = reinterpret_cast<const XkbEvent *>(&ev);
+
+            if (xkbEvent->any.xkb_type == XkbStateNotify) {
+                const unsigned int lockedMods = xkbEvent->state.locked_mods;
+                updateLockState(lockedMods & LockMask, lockedMods & numlockMask(display));
             }
-            printf("Overriding XI2 version to: %d.%d\n", maj, min);
         }
 
-        XIQueryVersion(display, &maj, &min);
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+
+            perror("DKeyboardMonitor poll");
+            return EXIT_FAILURE;
+        }
+
+        if (fds[1].revents & POLLIN)
+            break;
+
+        if (fds[0].revents & (POLLERR | POLLHUP))
+            return EXIT_FAILURE;
     }
 
-    return vers;
-}
-void select_events(Display* display)
-{
-    XIEventMask m;
-    m.deviceid = XIAllMasterDevices;
-    m.mask_len = XIMaskLen(XI_LASTEVENT);
-    m.mask = (unsigned char*)calloc(m.mask_len, sizeof(char));
-
-    //    XISetMask(m.mask, XI_RawKeyPress);
-    XISetMask(m.mask, XI_RawKeyRelease);
-    //    XISetMask(m.mask, XI_RawButtonPress);
-    //    XISetMask(m.mask, XI_RawButtonRelease);
-    //    XISetMask(m.mask, XI_RawMotion);
-    //    XISetMask(m.mask, XI_RawTouchBegin);
-    //    XISetMask(m.mask, XI_RawTouchUpdate);
-    //    XISetMask(m.mask, XI_RawTouchEnd);
-
-    XISelectEvents(display, DefaultRootWindow(display), &m, 1);
-
-    free(m.mask);
-    XSync(display, False);
+    return EXIT_SUCCESS;
 }
 
-int DKeyboardMonitor::listen(Display *display)
+void DKeyboardMonitor::updateLockState(bool capslock, bool numlock)
 {
-    Window root = DefaultRootWindow(display);
-    int root_x, root_y, nouse;
-    Window noused_window;
-    unsigned int mask;
-
-    while(1)
-    {
-        XEvent ev;
-        XGenericEventCookie *cookie = (XGenericEventCookie*)&ev.xcookie;
-        XNextEvent(display, (XEvent*)&ev);
-
-        if (XGetEventData(display, cookie) &&
-                cookie->type == GenericEvent &&
-                cookie->extension == xi2_opcode)
-        {
-            XQueryPointer(display, root, &noused_window, &noused_window, &root_x, &root_y, &nouse, &nouse, &mask);
-            XIRawEvent* event = static_cast<XIRawEvent*>(cookie->data);
-            switch (cookie->evtype)
-            {
-            case XI_RawButtonPress:
-                /*printf("Button press: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawButtonRelease:
-                /*printf("Button release: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawKeyPress:
-                break;
-            case XI_RawKeyRelease:
-                if (event->detail == 66) { // check if the key pressed is capslock first.
-                    Q_EMIT capslockStatusChanged(isCapslockOn());
-                } else if (event->detail == 77) {
-                    Q_EMIT numlockStatusChanged(isNumlockOn());
-                }
-                /*printf("Key release: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawTouchBegin:
-                //                printf("Touch begin: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            case XI_RawTouchUpdate:
-                //                printf("Touch update: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            case XI_RawTouchEnd:
-                //                printf("Touch end: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            }
-        }
+    const int state = (capslock ? CapslockOn : 0) | (numlock ? NumlockOn : 0);
+    const int oldState = m_lockState.fetchAndStoreOrdered(state);
 
-        XFreeEventData(display, cookie);
+    if (!m_lockStateValid.loadAcquire()) {
+        m_lockStateValid.storeRelease(1);
+        return;
     }
-    return EXIT_SUCCESS;
+
+    if ((oldState ^ state) & CapslockOn)
+        Q_EMIT capslockStatusChanged(capslock);
+
+    if ((oldState ^ state) & NumlockOn)
+        Q_EMIT numlockStatusChanged(numlock);
 }
 
 DKeyboardMonitor::DKeyboardMonitor() :
     QThread()
 {
+    m_wakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+DKeyboardMonitor::~DKeyboardMonitor()
+{
+    stop();
 
+    if (m_wakeupFd >= 0)
+        close(m_wakeupFd);
 }
 
 DKeyboardMonitor *DKeyboardMonitor::instance()
@@ -147,6 +128,10 @@ DKeyboardMonitor *DKeyboardMonitor::instance()
 
     if (!KeyboardMonitorInstance) {
         KeyboardMonitorInstance = new DKeyboardMonitor;
+
+        if (qApp) {
+            QObject::connect(qApp, &QCoreApplication::aboutToQuit, KeyboardMonitorInstance, &DKeyboardMonitor::stop);
+        }
     }
 
     return KeyboardMonitorInstance;
@@ -154,55 +139,95 @@ DKeyboardMonitor *DKeyboardMonitor::instance()
 
 bool DKeyboardMonitor::isCapslockOn()
 {
-    bool result;
-    unsigned int n = 0;
-    static Display* d = QX11Info::display();
+    if (m_lockStateValid.loadAcquire())
+        return m_lockState.loadAcquire() & CapslockOn;
 
-    XkbGetIndicatorState(d, XkbUseCoreKbd, &n);
-    result = (n & 0x01) != 0;
+    unsigned int lockedMods = 0;
+    static Display* d = QX11Info::display();
 
-    return result;
+    return queryLockedMods(d, &lockedMods) && (lockedMods & LockMask);
 }
 
 bool DKeyboardMonitor::isNumlockOn()
 {
-    bool result;
-    unsigned int n = 0;
-    static Display* d = QX11Info::display();
+    if (m_lockStateValid.loadAcquire())
+        return m_lockState.loadAcquire() & NumlockOn;
 
-    XkbGetIndicatorState(d, XkbUseCoreKbd, &n);
-    result = (n & 0x02) != 0;
+    unsigned int lockedMods = 0;
+    static Display* d = QX11Info::display();
 
-    return result;
+    return queryLockedMods(d, &lockedMods) && (lockedMods & numlockMask(d));
 }
 
 bool DKeyboardMonitor::setNumlockStatus(const bool &on)
 {
     Display* d = QX11Info::display();
+    const unsigned int mask = numlockMask(d);
+
+    if (!mask)
+        return false;
 
-    bool result = XkbLockModifiers(d, XkbUseCoreKbd, Mod2Mask, on ? Mod2Mask : 0);
+    bool result = XkbLockModifiers(d, XkbUseCoreKbd, mask, on ? mask : 0);
     XFlush(d);
 
     return result;
 }
 
+/*!
+  \internal
+  \brief 唤醒并结束监听线程，阻塞直到线程退出
+ */
+void DKeyboardMonitor::stop()
+{
+    if (!isRunning() || m_wakeupFd < 0)
+        return;
+
+    const uint64_t value = 1;
+    if (write(m_wakeupFd, &value, sizeof(value)) < 0)
+        perror("DKeyboardMonitor wakeup");
+
+    wait();
+}
+
 void DKeyboardMonitor::run()
 {
-    Display* display = XOpenDisplay(NULL);
-    int event, error;
+    if (m_wakeupFd < 0) {
+        fprintf(stderr, "DKeyboardMonitor: create wakeup fd failed.\n");
+        return;
+    }
 
-    if (!XQueryExtension(display, "XInputExtension", &xi2_opcode, &event, &error)) {
-        fprintf(stderr, "XInput2 not available.\n");
+    // 清除上一次 stop() 留下的唤醒计数
+    uint64_t value;
+    while (read(m_wakeupFd, &value, sizeof(value)) > 0) {}
+
+    Display* display = XOpenDisplay(NULL);
+    if (!display) {
+        fprintf(stderr, "DKeyboardMonitor: open display failed.\n");
         return;
     }
 
-    if (!xinput_version(display)) {
-        fprintf(stderr, "XInput2 extension not available\n");
+    int opcode, xkbEventBase, error;
+    int major = XkbMajorVersion, minor = XkbMinorVersion;
+
+    if (!XkbQueryExtension(display, &opcode, &xkbEventBase, &error, &major, &minor)) {
+        fprintf(stderr, "XKB extension not available.\n");
+        XCloseDisplay(display);
         return;
     }
 
-    select_events(display);
-    listen(display);
+    XkbSelectEventDetails(display, XkbUseCoreKbd, XkbStateNotify,
+                          XkbModifierLockMask, XkbModifierLockMask);
+
+    // 初始状态只需查询一次，之后由锁定修饰键的事件维护
+    unsigned int lockedMods = 0;
+    if (queryLockedMods(display, &lockedMods))
+        updateLockState(lockedMods & LockMask, lockedMods & numlockMask(display));
+    XFlush(display);
+
+    listen(display, xkbEventBase);
+
+    m_lockStateValid.storeRelease(0);
+    XCloseDisplay(display);
 }
 
 DWIDGET_END_NAMESPACE
@@ -6,6 +6,7 @@
 #define KEYBOARDMONITOR_H
 
 #include <QThread>
+#include <QAtomicInt>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include <QX11Info>
 #else
@@ -26,6 +27,8 @@ public:
     bool isNumlockOn();
     bool setNumlockStatus(const bool &on);
 
+    void stop();
+
 Q_SIGNALS:
     void capslockStatusChanged(bool on);
     void numlockStatusChanged(bool on);
@@ -35,8 +38,15 @@ protected:
 
 private:
     DKeyboardMonitor();
+    ~DKeyboardMonitor() override;
+
+    int listen(Display *display, int xkbEventBase);
+    void updateLockState(bool capslock, bool numlock);
 
-    int listen(Display *display);
+    // 由 XKB 事件维护的锁定键状态，监听线程运行时无需再向 X server 查询
+    QAtomicInt m_lockState;
+    QAtomicInt m_lockStateValid;
+    int m_wakeupFd = -1;
 };
 
 DWIDGET_END_NAMESPACE
@@ -14,9 +14,13 @@
 #include <QScroller>
 #include <QMouseEvent>
 #include <QFormLayout>
+#include <QTimer>
+
+#include <algorithm>
 
 #include <DSettings>
 #include <DSettingsGroup>
+#include <DSettingsOption>
 #include <DSuggestButton>
 #include <DPushButton>
 #include <DFontSizeManager>
@@ -41,15 +45,203 @@ public:
     QWidget *contentFrame = nullptr;
     QVBoxLayout *contentLayout = nullptr;
 
+    // 延迟创建的选项组，只有占位的 DBackgroundGroup，滚动到可见区域或者被导航选中时才创建选项控件
+    struct PendingGroup {
+        QPointer<DBackgroundGroup> group;
+        QVBoxLayout *layout;
+        QList<QPointer<DTK_CORE_NAMESPACE::DSettingsOption>> options;
+        QString subGroupKey;
+        QString groupKey;
+        int row;
+    };
+
+    void createOptionWidget(QVBoxLayout *bgGpLayout, QPointer<DTK_CORE_NAMESPACE::DSettingsOption> option, const QString &subGroupKey, int row);
+    int estimatedOptionHeight() const;
+    void loadGroup(int index);
+    void loadGroup(const QString &key);
+    void loadVisibleGroups();
+    void scheduleLoadVisibleGroups();
+    void activateContentLayout();
+    void ensureTitleIndex();
+
     QMap<QString, QWidget *> titles = {};
     QList<QWidget *> sortTitles = {};
 
     DSettingsWidgetFactory *widgetFactory = nullptr;
 
+    bool lazyLoad = false;
+    bool loadScheduled = false;
+    QByteArray translateContext;
+    QList<PendingGroup> pendingGroups;
+
+    // 按位置排序的可见标题，布局变化时重建，滚动时二分查找当前组
+    QVector<int> titleOffsets;
+    QVector<QWidget *> titleIndex;
+    bool titleIndexDirty = true;
+
     Content *q_ptr;
     Q_DECLARE_PUBLIC(Content)
 };
 
+void ContentPrivate::createOptionWidget(QVBoxLayout *bgGpLayout, QPointer<DTK_CORE_NAMESPACE::DSettingsOption> option, const QString &subGroupKey, int row)
+{
+    QWidget *wrapperWidget = new QWidget();
+    QHBoxLayout *hLay = new QHBoxLayout(wrapperWidget);
+    hLay->setContentsMargins(10, 6, 10, 6);
+    auto widget = widgetFactory->createItem(translateContext, option);
+
+    // 先尝试创建item
+    if (widget.first || widget.second) {
+        if (QLabel *label = qobject_cast<QLabel *>(widget.first)) {
+            if (widget.second)
+                label->setBuddy(widget.second);
+        }
+
+        if (widget.first) {
+            QWidget *container = new QWidget;
+            QHBoxLayout *hLayout = new QHBoxLayout(container);
+            hLayout->setSpacing(0);
+            hLayout->setContentsMargins(0, 0, 0, 0);
+            hLayout->addWidget(widget.first);
+            hLayout->addStretch(1);
+            hLay->addWidget(container, 2);
+        }
+        if (widget.second) {
+            hLay->addWidget(widget.second, 3);
+        }
+        wrapperWidget->setAccessibleName(QString("CustomWidgetAtContentRow%1BackgroundRow%2").arg(row).arg(bgGpLayout->count()));
+
+        if (widget.first) {
+            widget.first->setProperty("_d_dtk_group_key", subGroupKey);
+        }
+
+        if (widget.second) {
+            widget.second->setProperty("_d_dtk_group_key", subGroupKey);
+        }
+    } else {
+        QWidget *widget = widgetFactory->createWidget(translateContext, option);
+
+        if (widget) {
+            widget->setProperty("_d_dtk_group_key", subGroupKey);
+            hLay->addWidget(widget);
+            wrapperWidget->setAccessibleName(QString("DefaultWidgetAtContentRow%1BackgroundRow%2").arg(row).arg(bgGpLayout->count()));
+        }
+    }
+    bgGpLayout->addWidget(wrapperWidget);
+}
+
+// 占位高度只是粗略估计，避免为估算高度而创建控件
+int ContentPrivate::estimatedOptionHeight() const
+{
+    return qMax(contentFrame->fontMetrics().height() * 2, 36) + 12;
+}
+
+void ContentPrivate::loadGroup(int index)
+{
+    PendingGroup pending = pendingGroups.takeAt(index);
+
+    if (!pending.group)
+        return;
+
+    for (auto option : pending.options) {
+        if (option)
+            createOptionWidget(pending.layout, option, pending.subGroupKey, pending.row);
+    }
+
+    pending.group->setMinimumHeight(0);
+}
+
+void ContentPrivate::loadGroup(const QString &key)
+{
+    for (int i = pendingGroups.size() - 1; i >= 0; --i) {
+        const PendingGroup &pending = pendingGroups.at(i);
+
+        if (pending.subGroupKey == key || pending.groupKey == key)
+            loadGroup(i);
+    }
+}
+
+void ContentPrivate::loadVisibleGroups()
+{
+    loadScheduled = false;
+
+    if (pendingGroups.isEmpty() || !contentFrame->isVisible())
+        return;
+
+    QScrollBar *scrollBar = contentArea->verticalScrollBar();
+    const int value = scrollBar->value();
+    const int viewHeight = contentArea->viewport()->height();
+    // 多预加载一屏，减少滚动时出现占位的情况
+    const int top = value - viewHeight;
+    const int bottom = value + viewHeight * 2;
+
+    // 以第一个完全可见的标题为锚点，其上方的组创建后高度发生变化时保持可见内容不跳动
+    ensureTitleIndex();
+    const int anchorIndex = int(std::lower_bound(titleOffsets.cbegin(), titleOffsets.cend(), value) - titleOffsets.cbegin());
+    QWidget *anchor = titleIndex.value(anchorIndex);
+    const int anchorOffset = anchor ? anchor->y() - value : 0;
+    bool loaded = false;
+
+    for (int i = pendingGroups.size() - 1; i >= 0; --i) {
+        DBackgroundGroup *group = pendingGroups.at(i).group;
+
+        if (group && !group->isVisible())
+            continue;
+
+        if (group && (group->geometry().bottom() < top || group->y() > bottom))
+            continue;
+
+        loadGroup(i);
+        loaded = true;
+    }
+
+    if (loaded && anchor) {
+        activateContentLayout();
+        scrollBar->setValue(anchor->y() - anchorOffset);
+    }
+}
+
+void ContentPrivate::scheduleLoadVisibleGroups()
+{
+    Q_Q(Content);
+
+    if (loadScheduled || pendingGroups.isEmpty())
+        return;
+
+    loadScheduled = true;
+    QTimer::singleShot(0, q, [this] {
+        loadVisibleGroups();
+    });
+}
+
+// 只同步内容区域的布局，不处理应用中其他控件排队的布局请求
+void ContentPrivate::activateContentLayout()
+{
+    contentLayout->activate();
+
+    // 滚动区域据此按新的 sizeHint 调整内容区大小和滚动条范围
+    QEvent request(QEvent::LayoutRequest);
+    QCoreApplication::sendEvent(contentArea, &request);
+}
+
+void ContentPrivate::ensureTitleIndex()
+{
+    if (!titleIndexDirty)
+        return;
+
+    titleIndexDirty = false;
+    titleOffsets.clear();
+    titleIndex.clear();
+
+    for (QWidget *title : sortTitles) {
+        if (!title->isVisibleTo(contentFrame))
+            continue;
+
+        titleOffsets << title->y();
+        titleIndex << title;
+    }
+}
+
 Content::Content(QWidget *parent)
     : QWidget(parent)
     , d_ptr(new ContentPrivate(this))
@@ -81,6 +273,7 @@ Content::Content(QWidget *parent)
     d->contentFrame = new QWidget(this);
     d->contentFrame->setObjectName("SettingsContent");
     d->contentFrame->setAccessibleName("ContentSettingsFrame");
+    d->contentFrame->installEventFilter(this);
     d->contentLayout = new QVBoxLayout(d->contentFrame);
     d->contentLayout->setAlignment(Qt::AlignLeft);
     d->contentLayout->setContentsMargins(0, 0, 10, 0);
@@ -92,48 +285,43 @@ Content::Content(QWidget *parent)
     this, [ = ](int value) {
         Q_D(Content);
 
+        d->scheduleLoadVisibleGroups();
+
         // 当前显示的Title才参与滚动条的计算
-        QList<QWidget *> visableSortTitles;
-        for (auto idx = 0; idx < d->sortTitles.length(); ++idx) {
-            auto title = d->sortTitles[idx];
-            if (title->isVisible())
-                visableSortTitles.push_back(title);
-        }
-        if (visableSortTitles.empty())
+        d->ensureTitleIndex();
+        const QVector<int> &offsets = d->titleOffsets;
+        const int count = offsets.size();
+        if (count == 0)
             return;
 
-        auto currentTitle = visableSortTitles.first();
         auto viewHeight = d->contentArea->height();
 
-        QList<QWidget *> visableTitleList;
+        // 第一个参与计算的标题：value 落在其范围内的标题，否则为视图内的第一个标题
+        int first = int(std::lower_bound(offsets.cbegin(), offsets.cend(), value) - offsets.cbegin()) - 1;
+        if (first < 0 || first >= count - 1)
+            first = int(std::upper_bound(offsets.cbegin(), offsets.cend(), value) - offsets.cbegin());
+        if (first >= count || offsets.at(first) >= value + viewHeight)
+            first = -1;
 
-        for (auto idx = 0; idx < visableSortTitles.length(); ++idx) {
-            auto title = visableSortTitles[idx];
-            if (title->y() <= value) {
-                if (idx < visableSortTitles.length() - 1) {
-                    auto nextTitle = visableSortTitles[idx + 1];
-                    if (nextTitle->y() >= value) {
-                        visableTitleList.push_back(title);
-                    }
-                }
-            } else if (title->y() < (value + viewHeight)) {
-                visableTitleList.push_back(title);
-            }
-        }
+        QWidget *currentTitle = d->titleIndex.first();
+
+        if (first >= 0) {
+            // 最后一个参与计算的标题：视图内的最后一个标题
+            int last = int(std::lower_bound(offsets.cbegin(), offsets.cend(), value + viewHeight) - offsets.cbegin()) - 1;
+            if (last == count - 1 && offsets.at(last) <= value)
+                last = first;
 
-        if (!visableTitleList.isEmpty()) {
-            auto lastTitle = visableSortTitles.last();
-            if (value + viewHeight - 180 >= lastTitle->y()) {
-                currentTitle = visableTitleList.last();
+            if (value + viewHeight - 180 >= offsets.last()) {
+                currentTitle = d->titleIndex.at(last);
             } else {
-                currentTitle = visableTitleList.first();
+                currentTitle = d->titleIndex.at(first);
             }
         }
 
-        if (value >= visableSortTitles.last()->y())
-            currentTitle = visableSortTitles.last();
-        if (value <= visableSortTitles.first()->y())
-            currentTitle = visableSortTitles.first();
+        if (value >= offsets.last())
+            currentTitle = d->titleIndex.last();
+        if (value <= offsets.first())
+            currentTitle = d->titleIndex.first();
 
         if (currentTitle) {
             Q_EMIT scrollToGroup(currentTitle->property("key").toString());
@@ -182,6 +370,27 @@ void Content::setGroupVisible(const QString &key, bool visible)
             }
         }
     }
+
+    if (visible)
+        d->scheduleLoadVisibleGroups();
+}
+
+/*!
+  \internal
+  \brief 设置是否延迟创建选项控件，需要在 updateSettings 之前调用
+ */
+void Content::setLazyLoadEnabled(bool enabled)
+{
+    Q_D(Content);
+
+    d->lazyLoad = enabled;
+}
+
+bool Content::lazyLoadEnabled() const
+{
+    Q_D(const Content);
+
+    return d->lazyLoad;
 }
 
 void Content::onScrollToGroup(const QString &key)
@@ -192,6 +401,11 @@ void Content::onScrollToGroup(const QString &key)
 
     auto title = d->titles.value(key);
 
+    if (!d->pendingGroups.isEmpty()) {
+        d->loadGroup(key);
+        d->activateContentLayout();
+    }
+
     this->blockSignals(true);
     d->contentArea->verticalScrollBar()->setValue(title->y());
     this->blockSignals(false);
@@ -204,6 +418,7 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
 
     QString current_groupKey;
     QString current_subGroupKey;
+    d->translateContext = translateContext;
 
     for (auto groupKey : settings->groupKeys()) {
         current_groupKey = groupKey;
@@ -270,54 +485,24 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
             bgGroup->setUseWidgetBackground(false);
             d->contentLayout->addWidget(bgGroup);
 
+            if (d->lazyLoad) {
+                QList<QPointer<DTK_CORE_NAMESPACE::DSettingsOption>> options;
+                for (auto option : subgroup->childOptions()) {
+                    if (!option->isHidden())
+                        options << option;
+                }
+
+                bgGroup->setMinimumHeight(options.count() * d->estimatedOptionHeight());
+                d->pendingGroups << ContentPrivate::PendingGroup { bgGroup, bgGpLayout, options, current_subGroupKey, current_groupKey, d->contentLayout->count() };
+                continue;
+            }
+
             for (auto option : subgroup->childOptions()) {
                 if (option->isHidden()) {
                     continue;
                 }
 
-                QWidget *wrapperWidget = new QWidget();
-                QHBoxLayout *hLay = new QHBoxLayout(wrapperWidget);
-                hLay->setContentsMargins(10, 6, 10, 6);
-                auto widget = d->widgetFactory->createItem(translateContext, option);
-
-                // 先尝试创建item
-                if (widget.first || widget.second) {
-                    if (QLabel *label = qobject_cast<QLabel *>(widget.first)) {
-                        if (widget.second)
-                            label->setBuddy(widget.second);
-                    }
-
-                    if (widget.first) {
-                        QWidget *container = new QWidget;
-                        QHBoxLayout *hLayout = new QHBoxLayout(container);
-                        hLayout->setSpacing(0);
-                        hLayout->setContentsMargins(0, 0, 0, 0);
-                        hLayout->addWidget(widget.first);
-                        hLayout->addStretch(1);
-                        hLay->addWidget(container, 2);
-                    }
-                    if (widget.second) {
-                        hLay->addWidget(widget.second, 3);
-                    }
-                    wrapperWidget->setAccessibleName(QString("CustomWidgetAtContentRow%1BackgroundRow%2").arg(d->contentLayout->count()).arg(bgGpLayout->count()));
-
-                    if (widget.first) {
-                        widget.first->setProperty("_d_dtk_group_key", current_subGroupKey);
-                    }
-
-                    if (widget.second) {
-                        widget.second->setProperty("_d_dtk_group_key", current_subGroupKey);
-                    }
-                } else {
-                    QWidget *widget = d->widgetFactory->createWidget(translateContext, option);
-
-                    if (widget) {
-                        widget->setProperty("_d_dtk_group_key", current_subGroupKey);
-                        hLay->addWidget(widget);
-                        wrapperWidget->setAccessibleName(QString("DefaultWidgetAtContentRow%1BackgroundRow%2").arg(d->contentLayout->count()).arg(bgGpLayout->count()));
-                    }
-                }
-                bgGpLayout->addWidget(wrapperWidget);
+                d->createOptionWidget(bgGpLayout, option, current_subGroupKey, d->contentLayout->count());
             }
         }
         QSpacerItem *spaceItem = new QSpacerItem(0, 20,QSizePolicy::Minimum,QSizePolicy::Expanding);
@@ -342,6 +527,8 @@ void Content::updateSettings(const QByteArray &translateContext, QPointer<DTK_CO
     this, [ = ]() {
         settings->reset();
     });
+
+    d->scheduleLoadVisibleGroups();
 }
 
 void Content::mouseMoveEvent(QMouseEvent *event)
@@ -356,10 +543,21 @@ void Content::mouseMoveEvent(QMouseEvent *event)
     }
 }
 
+bool Content::eventFilter(QObject *watched, QEvent *event)
+{
+    Q_D(Content);
+
+    if (watched == d->contentFrame && (event->type() == QEvent::LayoutRequest || event->type() == QEvent::Resize))
+        d->titleIndexDirty = true;
+
+    return QWidget::eventFilter(watched, event);
+}
+
 void Content::resizeEvent(QResizeEvent *event)
 {
     Q_D(Content);
     d->contentFrame->setMaximumWidth(d->contentArea->width());
+    d->scheduleLoadVisibleGroups();
 
     return QWidget::resizeEvent(event);
 }
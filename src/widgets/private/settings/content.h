@@ -28,6 +28,8 @@ public:
     DSettingsWidgetFactory* widgetFactory() const;
     bool groupIsVisible(const QString &key) const;
     void setGroupVisible(const QString &key, bool visible);
+    void setLazyLoadEnabled(bool enabled);
+    bool lazyLoadEnabled() const;
 
 Q_SIGNALS:
     void scrollToGroup(const QString &key);
@@ -37,6 +39,7 @@ public Q_SLOTS:
     void updateSettings(const QByteArray &translateContext, QPointer<DTK_CORE_NAMESPACE::DSettings> settings);
 
 private:
+    bool eventFilter(QObject *watched, QEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
 
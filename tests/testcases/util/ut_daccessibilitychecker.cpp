@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "daccessibilitychecker.h"
+#include "private/daccessibilitychecker_p.h"
+
+#include <QLabel>
+#include <QListView>
+#include <QStandardItemModel>
+
+DWIDGET_USE_NAMESPACE
+
+struct CheckReport
+{
+    int widgetCount;
+    int ignoredCount;
+    QStringList widgetWarnings;
+    QStringList itemWarnings;
+};
+
+class ut_DAccessibilityChecker : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        window = new QWidget;
+        window->setAccessibleName("window");
+        new QLabel("label", window);
+        new QWidget(window);
+        QListView *view = new QListView(window);
+        view->setAccessibleName("view");
+        model = new QStandardItemModel(view);
+        model->appendRow(new QStandardItem("a"));
+        model->appendRow(new QStandardItem());
+        view->setModel(model);
+
+        checker = new DAccessibilityChecker;
+        checker->setOutputFormat(DAccessibilityChecker::FullFormat);
+        d = checker->d_func();
+
+        // 只检查本用例创建的窗口，不受其他用例遗留的顶层窗口影响
+        d->topLevelWidgets = { window };
+        d->ensureEventFilter();
+        d->knownTopLevelWidgets.insert(window);
+        d->pendingWidgets.append(window);
+    }
+    void TearDown() override
+    {
+        delete checker;
+        delete window;
+    }
+
+    CheckReport report() const
+    {
+        QStringList widgetWarnings = d->widgetsWarningList;
+        QStringList itemWarnings = d->itemWariningList;
+        widgetWarnings.sort();
+        itemWarnings.sort();
+        return { d->widgetCount, d->widgetIgnoredCount, widgetWarnings, itemWarnings };
+    }
+
+    CheckReport incrementalReport()
+    {
+        bool checked = false;
+        while (!d->processIncrementalChecks(&checked)) {}
+        d->collectIncrementalResult();
+        return report();
+    }
+
+    CheckReport fullReport()
+    {
+        d->check();
+        return report();
+    }
+
+    void expectSameReport()
+    {
+        const CheckReport incremental = incrementalReport();
+        const CheckReport full = fullReport();
+
+        ASSERT_EQ(incremental.widgetCount, full.widgetCount);
+        ASSERT_EQ(incremental.ignoredCount, full.ignoredCount);
+        ASSERT_EQ(incremental.widgetWarnings, full.widgetWarnings);
+        ASSERT_EQ(incremental.itemWarnings, full.itemWarnings);
+    }
+
+    QWidget *window = nullptr;
+    QStandardItemModel *model = nullptr;
+    DAccessibilityChecker *checker = nullptr;
+    DAccessibilityCheckerPrivate *d = nullptr;
+};
+
+TEST_F(ut_DAccessibilityChecker, initialCheck)
+{
+    expectSameReport();
+    ASSERT_EQ(d->widgetsWarningList.count(), 1);
+    ASSERT_EQ(d->itemWariningList.count(), 1);
+}
+
+TEST_F(ut_DAccessibilityChecker, insertAndRemove)
+{
+    expectSameReport();
+    const int widgetCount = d->widgetCount;
+
+    // 整棵子树只有根节点会收到 ChildAdded
+    QWidget *group = new QWidget(window);
+    new QWidget(group);
+    new QLabel("child", group);
+    model->appendRow(new QStandardItem());
+    expectSameReport();
+    ASSERT_EQ(d->widgetCount, widgetCount + 3);
+    ASSERT_EQ(d->itemWariningList.count(), 2);
+
+    // 子控件随父控件析构时不会收到 ChildRemoved
+    delete group;
+    model->removeRow(2);
+    expectSameReport();
+    ASSERT_EQ(d->widgetCount, widgetCount);
+    ASSERT_EQ(d->itemWariningList.count(), 1);
+}
+
+TEST_F(ut_DAccessibilityChecker, reparentSubtree)
+{
+    expectSameReport();
+
+    QWidget *group = new QWidget(window);
+    new QWidget(group);
+    expectSameReport();
+
+    group->setParent(nullptr);
+    expectSameReport();
+
+    group->setParent(window);
+    expectSameReport();
+}
+
+TEST_F(ut_DAccessibilityChecker, dataChanged)
+{
+    expectSameReport();
+    ASSERT_EQ(d->itemWariningList.count(), 1);
+
+    model->item(1)->setText("b");
+    expectSameReport();
+    ASSERT_TRUE(d->itemWariningList.isEmpty());
+}
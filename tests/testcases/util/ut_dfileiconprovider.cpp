@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "dfileiconprovider.h"
+#include "private/dfileiconprovider_p.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+
+DWIDGET_USE_NAMESPACE
+
+// 按扩展名匹配时，文件名 glob（CMakeLists.txt、*.tar.gz 等）不能被相同后缀的其他文件覆盖
+TEST(ut_DFileIconCache, extensionMatchIsPerFileName)
+{
+    const QStringList fileNames {
+        "notes.txt", "CMakeLists.txt", "archive.gz", "archive.tar.gz", "Makefile", "README"
+    };
+    QMimeDatabase database;
+
+    for (const QStringList &order : { fileNames, QStringList(fileNames.crbegin(), fileNames.crend()) }) {
+        DFileIconCache cache;
+        for (const QString &fileName : order) {
+            const QFileInfo info(QStringLiteral("/nonexistent/") + fileName);
+            ASSERT_EQ(cache.mimeTypeName(info, QMimeDatabase::MatchExtension),
+                      database.mimeTypeForFile(info, QMimeDatabase::MatchExtension).name())
+                << qPrintable(fileName);
+        }
+    }
+}
+
+TEST(ut_DFileIconProvider, requestIconMatchesIcon)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFile file(dir.filePath("test.txt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("text");
+    file.close();
+
+    DFileIconProvider provider;
+    const QFileInfo info(file.fileName());
+    const QIcon icon = provider.icon(info);
+
+    QObject context;
+    bool called = false;
+    QIcon requested;
+    provider.requestIcon(info, &context, [&](const QIcon &result) {
+        requested = result;
+        called = true;
+    });
+
+    ASSERT_TRUE(QTest::qWaitFor([&called] { return called; }));
+    // 同步和异步查询命中同一条缓存
+    ASSERT_EQ(requested.cacheKey(), icon.cacheKey());
+}
@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "dtrashmanager.h"
+
+#if DTK_VERSION < DTK_VERSION_CHECK(6, 0, 0, 0)
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+QT_WARNING_DISABLE_DEPRECATED
+
+DWIDGET_USE_NAMESPACE
+
+class ut_DTrashManager : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dataHome.isValid());
+        ASSERT_TRUE(sourceDir.isValid());
+
+        // 回收站位于 $XDG_DATA_HOME/Trash，与源文件在同一个设备上
+        oldDataHome = qgetenv("XDG_DATA_HOME");
+        qputenv("XDG_DATA_HOME", QFile::encodeName(dataHome.path()));
+
+        manager = DTrashManager::instance();
+        ASSERT_FALSE(manager->isRunning());
+    }
+
+    void TearDown() override
+    {
+        if (manager->isRunning()) {
+            manager->cancel();
+            QTest::qWaitFor([this] { return !manager->isRunning(); });
+        }
+
+        if (oldDataHome.isNull())
+            qunsetenv("XDG_DATA_HOME");
+        else
+            qputenv("XDG_DATA_HOME", oldDataHome);
+    }
+
+    QStringList createFiles(int count)
+    {
+        QStringList filePaths;
+        for (int i = 0; i < count; ++i) {
+            QFile file(sourceDir.filePath(QString("file%1.txt").arg(i)));
+            if (!file.open(QIODevice::WriteOnly))
+                return QStringList();
+
+            file.write("trash");
+            filePaths << file.fileName();
+        }
+
+        return filePaths;
+    }
+
+    QDir trashDir(const QString &name) const
+    {
+        return QDir(dataHome.filePath("Trash/" + name));
+    }
+
+    // 信号排队到测试线程，finished 之前的 progressChanged 和 itemFailed 都已送达
+    bool waitForFinished(bool *ok)
+    {
+        bool called = false;
+        QObject context;
+        QObject::connect(manager, &DTrashManager::finished, &context, [&](bool result) {
+            *ok = result;
+            called = true;
+        });
+
+        return QTest::qWaitFor([&called] { return called; });
+    }
+
+    QTemporaryDir dataHome;
+    QTemporaryDir sourceDir;
+    QByteArray oldDataHome;
+    DTrashManager *manager = nullptr;
+};
+
+TEST_F(ut_DTrashManager, moveProgress)
+{
+    const QStringList filePaths = createFiles(5);
+    ASSERT_EQ(filePaths.size(), 5);
+
+    QObject context;
+    QList<QPair<int, int>> progress;
+    QObject::connect(manager, &DTrashManager::progressChanged, &context, [&](int done, int total) {
+        progress << qMakePair(done, total);
+    });
+
+    ASSERT_TRUE(manager->moveToTrash(filePaths));
+    ASSERT_TRUE(manager->isRunning());
+    // finished 发出之前不能开始新的任务
+    ASSERT_FALSE(manager->cleanTrashAsync());
+
+    bool ok = false;
+    ASSERT_TRUE(waitForFinished(&ok));
+    ASSERT_TRUE(ok);
+    ASSERT_FALSE(manager->isRunning());
+
+    ASSERT_EQ(progress.size(), filePaths.size());
+    for (int i = 0; i < progress.size(); ++i)
+        ASSERT_EQ(progress.at(i), qMakePair(i + 1, filePaths.size()));
+
+    for (const QString &filePath : filePaths)
+        ASSERT_FALSE(QFile::exists(filePath));
+
+    ASSERT_EQ(trashDir("files").entryList(QDir::Files).size(), filePaths.size());
+    ASSERT_EQ(trashDir("info").entryList(QDir::Files).size(), filePaths.size());
+}
+
+TEST_F(ut_DTrashManager, itemFailed)
+{
+    QStringList filePaths = createFiles(2);
+    ASSERT_EQ(filePaths.size(), 2);
+    const QString missing = sourceDir.filePath("missing.txt");
+    filePaths.insert(1, missing);
+
+    QObject context;
+    QStringList failed;
+    int done = 0;
+    QObject::connect(manager, &DTrashManager::itemFailed, &context, [&](const QString &filePath, const QString &errorString) {
+        ASSERT_FALSE(errorString.isEmpty());
+        failed << filePath;
+    });
+    QObject::connect(manager, &DTrashManager::progressChanged, &context, [&](int value) {
+        done = value;
+    });
+
+    ASSERT_TRUE(manager->moveToTrash(filePaths));
+
+    bool ok = true;
+    ASSERT_TRUE(waitForFinished(&ok));
+    ASSERT_FALSE(ok);
+    ASSERT_EQ(failed, QStringList { missing });
+    // 失败的文件不影响其余文件
+    ASSERT_EQ(done, filePaths.size());
+    ASSERT_EQ(trashDir("files").entryList(QDir::Files).size(), 2);
+}
+
+TEST_F(ut_DTrashManager, cancel)
+{
+    const QStringList filePaths = createFiles(10);
+    ASSERT_EQ(filePaths.size(), 10);
+
+    bool ok = true;
+    {
+        // 在工作线程中处理完第一个文件后立即取消
+        QObject context;
+        QAtomicInt progressCount;
+        QObject::connect(manager, &DTrashManager::progressChanged, &context, [&] {
+            progressCount.fetchAndAddOrdered(1);
+            manager->cancel();
+        }, Qt::DirectConnection);
+
+        ASSERT_TRUE(manager->moveToTrash(filePaths));
+        ASSERT_TRUE(waitForFinished(&ok));
+        ASSERT_FALSE(ok);
+        ASSERT_EQ(progressCount.loadAcquire(), 1);
+    }
+
+    ASSERT_FALSE(QFile::exists(filePaths.first()));
+    for (int i = 1; i < filePaths.size(); ++i)
+        ASSERT_TRUE(QFile::exists(filePaths.at(i)));
+
+    // 取消后可以开始新的任务
+    ASSERT_TRUE(manager->moveToTrash(filePaths.mid(1)));
+    ASSERT_TRUE(waitForFinished(&ok));
+    ASSERT_TRUE(ok);
+}
+
+TEST_F(ut_DTrashManager, cleanTrashAsync)
+{
+    const QStringList filePaths = createFiles(4);
+    ASSERT_EQ(filePaths.size(), 4);
+    ASSERT_TRUE(manager->moveToTrash(filePaths));
+
+    bool ok = false;
+    ASSERT_TRUE(waitForFinished(&ok));
+    ASSERT_TRUE(ok);
+
+    // 没有对应条目的 trashinfo 也会被清理
+    QFile orphan(trashDir("info").filePath("orphan.txt.trashinfo"));
+    ASSERT_TRUE(orphan.open(QIODevice::WriteOnly));
+    orphan.close();
+    ASSERT_FALSE(manager->trashIsEmpty());
+
+    QObject context;
+    QList<int> progress;
+    QObject::connect(manager, &DTrashManager::progressChanged, &context, [&](int done, int total) {
+        ASSERT_EQ(total, filePaths.size());
+        progress << done;
+    });
+
+    ASSERT_TRUE(manager->cleanTrashAsync());
+    ASSERT_TRUE(waitForFinished(&ok));
+    ASSERT_TRUE(ok);
+
+    // 并行删除的进度可能合并，但按递增顺序送达且以总数结束
+    ASSERT_FALSE(progress.isEmpty());
+    for (int i = 1; i < progress.size(); ++i)
+        ASSERT_LT(progress.at(i - 1), progress.at(i));
+    ASSERT_EQ(progress.last(), filePaths.size());
+    ASSERT_TRUE(manager->trashIsEmpty());
+    ASSERT_TRUE(trashDir("files").entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden).isEmpty());
+}
+
+#endif
@@ -11,6 +11,21 @@
 
 DWIDGET_USE_NAMESPACE
 
+class GeometryEventCounter : public QObject
+{
+public:
+    int count = 0;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Move || event->type() == QEvent::Resize)
+            ++count;
+
+        return QObject::eventFilter(watched, event);
+    }
+};
+
 class ut_DAnchors : public testing::Test
 {
 protected:
@@ -86,3 +101,66 @@ TEST_F(ut_DAnchors, testDAnchors)
     ASSERT_EQ(anchor2.horizontalCenterOffset(), offset);
     ASSERT_EQ(anchor2.verticalCenterOffset(), offset);
 }
+
+TEST_F(ut_DAnchors, testLoopBind)
+{
+    QLabel *lb1 = new QLabel("anchor1", widget);
+    QLabel *lb2 = new QLabel("anchor2", widget);
+    QLabel *lb3 = new QLabel("anchor3", widget);
+
+    DAnchors<QLabel> anchor1(lb1);
+    DAnchors<QLabel> anchor2(lb2);
+    DAnchors<QLabel> anchor3(lb3);
+
+    ASSERT_TRUE(anchor2.setLeft(anchor1.right()));
+    ASSERT_TRUE(anchor3.setLeft(anchor2.right()));
+
+    // anchor1 -> anchor3 -> anchor2 -> anchor1 构成环
+    ASSERT_FALSE(anchor1.setLeft(anchor3.right()));
+    ASSERT_EQ(anchor1.errorCode(), DAnchorsBase::LoopBind);
+
+    // 不同方向上的锚定不构成环
+    ASSERT_TRUE(anchor1.setTop(anchor3.bottom()));
+}
+
+TEST_F(ut_DAnchors, testSolveOnce)
+{
+    // 可见控件的几何变化会同步发出事件，沿锚定关系传递
+    widget->show();
+    QWidget *parent = new QWidget(widget);
+    parent->setGeometry(0, 0, 200, 300);
+    parent->show();
+
+    QWidget *w0 = new QWidget(parent);
+    QWidget *w1 = new QWidget(parent);
+    QWidget *w2 = new QWidget(parent);
+    QWidget *w3 = new QWidget(parent);
+    for (QWidget *w : { w0, w1, w2, w3 }) {
+        w->resize(50, 20);
+        w->show();
+    }
+
+    DAnchors<QWidget> anchor0(w0);
+    DAnchors<QWidget> anchor1(w1);
+    DAnchors<QWidget> anchor2(w2);
+    DAnchors<QWidget> anchor3(w3);
+
+    // w0 贴底，w1、w2 依次叠在上方，w3 从 w2 的顶部延伸到 w0 的底部，同时依赖 w0 和 w2
+    ASSERT_TRUE(anchor0.setAnchor(Qt::AnchorBottom, parent, Qt::AnchorBottom));
+    ASSERT_TRUE(anchor1.setBottom(anchor0.top()));
+    ASSERT_TRUE(anchor2.setBottom(anchor1.top()));
+    ASSERT_TRUE(anchor3.setTop(anchor2.top()));
+    ASSERT_TRUE(anchor3.setBottom(anchor0.bottom()));
+    ASSERT_EQ(w3->geometry(), QRect(0, 240, 50, 60));
+
+    GeometryEventCounter counter;
+    w3->installEventFilter(&counter);
+    parent->resize(200, 400);
+
+    ASSERT_EQ(w0->geometry(), QRect(0, 380, 50, 20));
+    ASSERT_EQ(w1->geometry(), QRect(0, 360, 50, 20));
+    ASSERT_EQ(w2->geometry(), QRect(0, 340, 50, 20));
+    ASSERT_EQ(w3->geometry(), QRect(0, 340, 50, 60));
+    // w3 在 w0 和 w2 都更新后只计算一次，不会先用过期的 w2 调整尺寸
+    ASSERT_EQ(counter.count, 1);
+}
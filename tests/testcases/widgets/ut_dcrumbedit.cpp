@@ -6,8 +6,10 @@
 #include <QTest>
 #include <QClipboard>
 #include <QMimeData>
+#include <QAbstractTextDocumentLayout>
 
 #include "dcrumbedit.h"
+#include "private/dcrumbedit_p.h"
 #include <QDebug>
 
 DWIDGET_USE_NAMESPACE
@@ -104,3 +106,30 @@ TEST_F(ut_DCrumbedit, createMimeDataFromSelection)
     ASSERT_EQ(qApp->clipboard()->text(), "测试1 人物 测试2 儿童 测试3 照片 测试代码调试添加GTest");
     delete data;
 }
+
+TEST_F(ut_DCrumbedit, crumbGeometryCache)
+{
+    const int count = 200;
+    for (int i = 0; i < count; ++i)
+        edit->appendCrumb(QString("crumb%1").arg(i));
+
+    CrumbObjectInterface *object = edit->findChild<CrumbObjectInterface *>();
+    ASSERT_TRUE(object);
+
+    edit->resize(400, 300);
+    edit->document()->documentLayout()->documentSize();
+    edit->grab();
+
+    // 每个 crumb 一条缓存，重绘和重新排版只查找缓存，不再创建 CrumbGeometry
+    ASSERT_EQ(object->geometries.size(), count);
+    const QSize rectSize = object->geometries.begin().value().rectSize;
+
+    edit->grab();
+    edit->resize(300, 400);
+    edit->document()->documentLayout()->documentSize();
+    edit->grab();
+
+    ASSERT_EQ(object->geometries.size(), count);
+    ASSERT_EQ(object->geometries.begin().value().rectSize, rectSize);
+    ASSERT_EQ(edit->crumbList().count(), count);
+}
@@ -142,3 +142,29 @@ TEST_F(ut_DFlowLayout, takeAt)
     ASSERT_EQ(item, item1);
     delete item1;
 };
+
+TEST_F(ut_DFlowLayout, heightForWidth)
+{
+    // QSpacerItem 总是为空，会被布局跳过，这里使用固定大小的控件
+    auto addFixedWidget = [this] {
+        QWidget *widget = new QWidget(holder);
+        widget->setFixedSize(40, 10);
+        target->addWidget(widget);
+    };
+
+    target->setSpacing(0);
+    target->setContentsMargins(0, 0, 0, 0);
+    addFixedWidget();
+    addFixedWidget();
+    const int height = target->heightForWidth(50);
+    ASSERT_EQ(height, 20);
+    ASSERT_EQ(target->heightForWidth(50), height);
+
+    addFixedWidget();
+    ASSERT_GT(target->heightForWidth(50), height);
+
+    QLayoutItem *item = target->takeAt(2);
+    delete item->widget();
+    delete item;
+    ASSERT_EQ(target->heightForWidth(50), height);
+};
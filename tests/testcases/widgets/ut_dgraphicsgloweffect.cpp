@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include <gtest/gtest.h>
+#include <QWidget>
 
 #include "dgraphicsgloweffect.h"
 DWIDGET_USE_NAMESPACE
@@ -65,3 +66,29 @@ TEST_F(ut_DGraphicsGlowEffect, setYOffset)
     target->setYOffset(1);
     ASSERT_EQ(target->yOffset(), 1);
 };
+
+TEST(ut_DGraphicsGlowEffectRender, cachedGlow)
+{
+    QWidget parent;
+    parent.resize(100, 100);
+    QWidget *child = new QWidget(&parent);
+    child->setGeometry(30, 30, 40, 40);
+    child->setAutoFillBackground(true);
+
+    DGraphicsGlowEffect *effect = new DGraphicsGlowEffect;
+    effect->setColor(Qt::black);
+    child->setGraphicsEffect(effect);
+
+    const QImage first = parent.grab().toImage();
+    ASSERT_EQ(first, parent.grab().toImage());
+
+    child->move(20, 20);
+    ASSERT_NE(first, parent.grab().toImage());
+    child->move(30, 30);
+    ASSERT_EQ(first, parent.grab().toImage());
+
+    // 参数变化后需要重新生成
+    effect->setColor(Qt::red);
+    child->update();
+    ASSERT_NE(first, parent.grab().toImage());
+}
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QAtomicInt>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThreadPool>
+
+#include "private/dprinterdiscovery_p.h"
+
+DWIDGET_USE_NAMESPACE
+
+class ut_DPrinterDiscovery : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        discovery = new DPrinterDiscovery;
+
+        // 不访问 CUPS，能力中记录打印机名称以便检查结果对应的打印机
+        discovery->m_loadCapabilities = [this](const QString &printerName) {
+            loadCount.fetchAndAddOrdered(1);
+
+            DPrinterCapabilities capabilities;
+            capabilities.pageSizes << QPageSize(QPageSize::A4);
+            capabilities.colorModes << QPrint::GrayScale;
+            capabilities.cupsColorModel = printerName.toUtf8();
+            return capabilities;
+        };
+    }
+
+    void TearDown() override
+    {
+        // 等待工作线程中的任务结束，它们引用了测试对象
+        QThreadPool::globalInstance()->waitForDone();
+        delete discovery;
+    }
+
+    bool discover(const QStringList &printerNames, const QString &defaultPrinterName = QString())
+    {
+        DPrinterDiscoveryResult result { printerNames, defaultPrinterName };
+        discovery->m_discover = [result] {
+            return result;
+        };
+
+        QSignalSpy spy(discovery, &DPrinterDiscovery::discovered);
+        discovery->refresh();
+        return spy.wait(5000);
+    }
+
+    bool waitForCapabilities(const QString &printerName)
+    {
+        return QTest::qWaitFor([this, printerName] {
+            return discovery->m_capabilities.contains(printerName);
+        });
+    }
+
+    DPrinterDiscovery *discovery = nullptr;
+    QAtomicInt loadCount;
+};
+
+TEST_F(ut_DPrinterDiscovery, printerDiff)
+{
+    QSignalSpy added(discovery, &DPrinterDiscovery::printerAdded);
+    QSignalSpy removed(discovery, &DPrinterDiscovery::printerRemoved);
+
+    ASSERT_FALSE(discovery->isReady());
+    ASSERT_TRUE(discover({"A", "B"}, "B"));
+    ASSERT_TRUE(discovery->isReady());
+    ASSERT_EQ(discovery->printerNames(), QStringList({"A", "B"}));
+    ASSERT_EQ(discovery->defaultPrinterName(), "B");
+    ASSERT_EQ(added.count(), 2);
+    ASSERT_EQ(removed.count(), 0);
+
+    added.clear();
+    ASSERT_TRUE(discover({"B", "C"}, "C"));
+    ASSERT_TRUE(discovery->contains("C"));
+    ASSERT_FALSE(discovery->contains("A"));
+    ASSERT_EQ(added.count(), 1);
+    ASSERT_EQ(added.first().first().toString(), "C");
+    ASSERT_EQ(removed.count(), 1);
+    ASSERT_EQ(removed.first().first().toString(), "A");
+}
+
+TEST_F(ut_DPrinterDiscovery, capabilitiesCache)
+{
+    QSignalSpy ready(discovery, &DPrinterDiscovery::capabilitiesReady);
+
+    // 枚举完成后在后台读取所有打印机的能力
+    ASSERT_TRUE(discover({"A"}));
+    ASSERT_TRUE(waitForCapabilities("A"));
+    ASSERT_EQ(ready.count(), 1);
+    ASSERT_EQ(loadCount.loadAcquire(), 1);
+
+    // 已缓存时直接返回，不再读取
+    const DPrinterCapabilities capabilities = discovery->capabilities("A");
+    ASSERT_TRUE(capabilities.loaded);
+    ASSERT_EQ(capabilities.cupsColorModel, QByteArray("A"));
+    ASSERT_TRUE(capabilities.supportsColorMode(QPrint::GrayScale));
+    ASSERT_FALSE(capabilities.supportsColorMode(QPrint::Color));
+    discovery->capabilities("A");
+    ASSERT_EQ(loadCount.loadAcquire(), 1);
+
+    // 未缓存时不阻塞，返回未加载的结果并在读取完成后通知
+    ASSERT_FALSE(discovery->capabilities("D").loaded);
+    ASSERT_TRUE(waitForCapabilities("D"));
+    ASSERT_EQ(ready.last().first().toString(), "D");
+    ASSERT_TRUE(discovery->capabilities("D").loaded);
+    ASSERT_EQ(loadCount.loadAcquire(), 2);
+}
+
+TEST_F(ut_DPrinterDiscovery, capabilitiesInvalidation)
+{
+    ASSERT_TRUE(discover({"A", "B"}));
+    ASSERT_TRUE(waitForCapabilities("A"));
+    ASSERT_TRUE(waitForCapabilities("B"));
+    ASSERT_EQ(loadCount.loadAcquire(), 2);
+
+    // 打印机被移除时丢弃其能力
+    ASSERT_TRUE(discover({"B"}));
+    ASSERT_FALSE(discovery->m_capabilities.contains("A"));
+    ASSERT_TRUE(discovery->m_capabilities.contains("B"));
+
+    // CUPS 配置变化后，下一次枚举完成时重新读取所有打印机的能力
+    QSignalSpy spy(discovery, &DPrinterDiscovery::discovered);
+    discovery->onConfigChanged();
+    ASSERT_TRUE(spy.wait(5000));
+    ASSERT_TRUE(QTest::qWaitFor([this] { return loadCount.loadAcquire() == 3; }));
+    ASSERT_TRUE(waitForCapabilities("B"));
+    ASSERT_TRUE(discovery->capabilities("B").loaded);
+    ASSERT_EQ(loadCount.loadAcquire(), 3);
+}
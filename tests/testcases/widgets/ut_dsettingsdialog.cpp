@@ -3,9 +3,19 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include <gtest/gtest.h>
+#include <DBackgroundGroup>
+#include <DSettings>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLayout>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QTest>
 
 #include "dsettingsdialog.h"
 DWIDGET_USE_NAMESPACE
+DCORE_USE_NAMESPACE
 class ut_DSettingsDialog : public testing::Test
 {
 protected:
@@ -19,8 +29,67 @@ protected:
             delete target;
             target = nullptr;
         }
+        if (settings) {
+            delete settings;
+            settings = nullptr;
+        }
+    }
+
+    // 每个组包含一个子组，子组中有 optionCount 个选项
+    void createSettings(int groupCount, int optionCount)
+    {
+        QJsonArray groups;
+        for (int i = 0; i < groupCount; ++i) {
+            QJsonArray options;
+            for (int j = 0; j < optionCount; ++j) {
+                options.append(QJsonObject {
+                    {"key", QString("option%1").arg(j)},
+                    {"name", QString("Option %1").arg(j)},
+                    {"type", "lineedit"},
+                    {"default", ""}
+                });
+            }
+
+            QJsonObject subGroup {{"key", "sub"}, {"name", "Sub"}, {"options", options}};
+            groups.append(QJsonObject {
+                {"key", QString("group%1").arg(i)},
+                {"name", QString("Group %1").arg(i)},
+                {"groups", QJsonArray {subGroup}}
+            });
+        }
+
+        settings = DSettings::fromJson(QJsonDocument(QJsonObject {{"groups", groups}}).toJson());
+    }
+
+    DBackgroundGroup *settingsGroup(int index) const
+    {
+        const QString key = QString("group%1.sub").arg(index);
+        for (DBackgroundGroup *group : target->findChildren<DBackgroundGroup *>()) {
+            if (group->property("key").toString() == key)
+                return group;
+        }
+
+        return nullptr;
+    }
+
+    bool groupIsLoaded(int index) const
+    {
+        DBackgroundGroup *group = settingsGroup(index);
+        return group && group->layout()->count() > 0;
+    }
+
+    QScrollArea *contentArea() const
+    {
+        for (QScrollArea *area : target->findChildren<QScrollArea *>()) {
+            if (area->widget() && area->widget()->objectName() == "SettingsContent")
+                return area;
+        }
+
+        return nullptr;
     }
+
     DSettingsDialog *target = nullptr;
+    DSettings *settings = nullptr;
 };
 
 TEST_F(ut_DSettingsDialog, setGroupVisible)
@@ -28,3 +97,47 @@ TEST_F(ut_DSettingsDialog, setGroupVisible)
     target->setGroupVisible("setGroupVisible", true);
     ASSERT_EQ(target->groupIsVisible("setGroupVisible"), target->isVisible() && target->groupIsVisible("setGroupVisible"));
 };
+
+TEST_F(ut_DSettingsDialog, setLazyLoadEnabled)
+{
+    ASSERT_FALSE(target->lazyLoadEnabled());
+    target->setLazyLoadEnabled(true);
+    ASSERT_TRUE(target->lazyLoadEnabled());
+};
+
+TEST_F(ut_DSettingsDialog, lazyLoadGroups)
+{
+    const int groupCount = 20;
+    createSettings(groupCount, 6);
+    ASSERT_TRUE(settings);
+
+    target->setLazyLoadEnabled(true);
+    target->updateSettings(settings);
+
+    // 只创建了占位的组，还没有选项控件
+    for (int i = 0; i < groupCount; ++i) {
+        ASSERT_TRUE(settingsGroup(i));
+        ASSERT_FALSE(groupIsLoaded(i));
+    }
+
+    target->resize(680, 400);
+    target->show();
+
+    // 可见区域内的组在下一次事件循环中创建，远处的组仍然是占位
+    ASSERT_TRUE(QTest::qWaitFor([this] { return groupIsLoaded(0); }));
+    ASSERT_FALSE(groupIsLoaded(groupCount / 2));
+    ASSERT_FALSE(groupIsLoaded(groupCount - 1));
+
+    // 滚动到占位组所在的位置后创建其选项控件
+    QScrollArea *area = contentArea();
+    ASSERT_TRUE(area);
+    area->verticalScrollBar()->setValue(settingsGroup(groupCount / 2)->y());
+    ASSERT_TRUE(QTest::qWaitFor([this] { return groupIsLoaded(groupCount / 2); }));
+    ASSERT_FALSE(groupIsLoaded(groupCount - 1));
+
+    // 导航选中的组立即创建，并滚动到其标题
+    target->scrollToGroup(QString("group%1").arg(groupCount - 1));
+    ASSERT_TRUE(groupIsLoaded(groupCount - 1));
+    ASSERT_EQ(settingsGroup(groupCount - 1)->layout()->count(), 6);
+    ASSERT_GT(area->verticalScrollBar()->value(), 0);
+};
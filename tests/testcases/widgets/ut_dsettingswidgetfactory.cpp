@@ -6,6 +6,7 @@
 #include <DSettingsOption>
 #include <QJsonObject>
 #include <QWidget>
+#include <DKeySequenceEdit>
 
 #include "dsettingswidgetfactory.h"
 DWIDGET_USE_NAMESPACE
@@ -96,3 +97,69 @@ TEST_F(ut_DSettingsWidgetFactory, registerWidget2)
     ASSERT_EQ(result.second->parent(), parent);
 
 };
+
+TEST_F(ut_DSettingsWidgetFactory, shortcutConflict)
+{
+    QJsonObject opt;
+    opt["type"] = "shortcut";
+    opt["default"] = "Ctrl+A";
+    auto option1 = DTK_CORE_NAMESPACE::DSettingsOption::fromJson("shortcut1", opt);
+    auto option2 = DTK_CORE_NAMESPACE::DSettingsOption::fromJson("shortcut2", opt);
+
+    auto item1 = target->createItem(option1);
+    auto item2 = target->createItem(option2);
+    auto edit1 = qobject_cast<DKeySequenceEdit *>(item1.second);
+    auto edit2 = qobject_cast<DKeySequenceEdit *>(item2.second);
+    ASSERT_TRUE(edit1 && edit2);
+    ASSERT_EQ(edit1->keySequence(), QKeySequence("Ctrl+A"));
+    ASSERT_TRUE(edit2->keySequence().isEmpty());
+
+    // 每个 factory 各自检测冲突，互不影响
+    DSettingsWidgetFactory factory;
+    auto item3 = factory.createItem(option2);
+    auto edit3 = qobject_cast<DKeySequenceEdit *>(item3.second);
+    ASSERT_TRUE(edit3);
+    ASSERT_EQ(edit3->keySequence(), QKeySequence("Ctrl+A"));
+
+    for (auto item : {item1, item2, item3}) {
+        delete item.first;
+        delete item.second;
+    }
+    option1->deleteLater();
+    option2->deleteLater();
+};
+
+TEST_F(ut_DSettingsWidgetFactory, shortcutLifetime)
+{
+    QJsonObject opt;
+    opt["type"] = "shortcut";
+    opt["default"] = "Ctrl+A";
+    auto option = DTK_CORE_NAMESPACE::DSettingsOption::fromJson("shortcut", opt);
+
+    // factory 先销毁，之后的值变化不再访问它的索引
+    auto factory = new DSettingsWidgetFactory();
+    auto item = factory->createItem(option);
+    auto edit = qobject_cast<DKeySequenceEdit *>(item.second);
+    ASSERT_TRUE(edit);
+    delete factory;
+    option->setValue("Ctrl+B");
+    ASSERT_EQ(edit->keySequence(), QKeySequence("Ctrl+A"));
+    delete item.first;
+    delete item.second;
+
+    // 控件先销毁，之后的值变化不再访问该控件
+    item = target->createItem(option);
+    ASSERT_TRUE(qobject_cast<DKeySequenceEdit *>(item.second));
+    delete item.first;
+    delete item.second;
+    option->setValue("Ctrl+C");
+
+    // 控件销毁后从索引中移除，新控件可以使用同一快捷键
+    item = target->createItem(option);
+    edit = qobject_cast<DKeySequenceEdit *>(item.second);
+    ASSERT_TRUE(edit);
+    ASSERT_EQ(edit->keySequence(), QKeySequence("Ctrl+C"));
+    delete item.first;
+    delete item.second;
+    option->deleteLater();
+};
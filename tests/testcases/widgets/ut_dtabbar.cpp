@@ -5,7 +5,9 @@
 #include <gtest/gtest.h>
 
 #include <QIcon>
+#include <QPainter>
 #include <QSignalSpy>
+#include <QStyleOptionTab>
 
 #include "dtabbar.h"
 DWIDGET_USE_NAMESPACE
@@ -221,6 +223,22 @@ TEST_F(ut_DTabBar, setTabText)
     ASSERT_EQ(target->tabText(0), "setTabText");
 };
 
+TEST_F(ut_DTabBar, tabSizeHintCache)
+{
+    target->insertTab(0, "a");
+    target->insertTab(1, "a much longer tab text");
+    const QSize shortHint = target->tabSizeHint(0);
+    const QSize longHint = target->tabSizeHint(1);
+    ASSERT_LT(shortHint.width(), longHint.width());
+
+    target->moveTab(1, 0);
+    ASSERT_EQ(target->tabSizeHint(0), longHint);
+    ASSERT_EQ(target->tabSizeHint(1), shortHint);
+
+    target->setTabText(1, "a much longer tab text");
+    ASSERT_EQ(target->tabSizeHint(1), longHint);
+};
+
 TEST_F(ut_DTabBar, setTabToolTip)
 {
     target->insertTab(0, "insertTab1");
@@ -252,3 +270,50 @@ TEST_F(ut_DTabBar, setVisibleAddButton)
     target->setVisibleAddButton(true);
     ASSERT_EQ(target->visibleAddButton(), true);
 };
+
+static QStyleOptionTab tabOption(DTabBar *tabBar, int index)
+{
+    QStyleOptionTab option;
+    option.initFrom(tabBar);
+    option.text = tabBar->tabText(index);
+    option.rect = QRect(0, 0, 120, 36);
+    return option;
+}
+
+TEST_F(ut_DTabBar, dragPixmapCache)
+{
+    target->addTab("tab1");
+    target->addTab("tab2");
+    target->addTab("tab3");
+
+    const QPixmap pixmap = target->createDragPixmapFromTab(0, tabOption(target, 0), nullptr);
+    ASSERT_FALSE(pixmap.isNull());
+
+    // 移动标签页会重新布局，但标签页本身没有变化，仍然命中缓存
+    target->moveTab(0, 2);
+    target->moveTab(2, 1);
+    ASSERT_EQ(target->createDragPixmapFromTab(1, tabOption(target, 1), nullptr).cacheKey(), pixmap.cacheKey());
+
+    // 文本变化后重新绘制
+    target->setTabText(1, "tab1 changed");
+    ASSERT_NE(target->createDragPixmapFromTab(1, tabOption(target, 1), nullptr).cacheKey(), pixmap.cacheKey());
+};
+
+class CustomPaintTabBar : public DTabBar
+{
+protected:
+    void paintTab(QPainter *painter, int index, const QStyleOptionTab &option) const override
+    {
+        painter->fillRect(option.rect, tabData(index).value<QColor>());
+    }
+};
+
+TEST_F(ut_DTabBar, dragPixmapCustomPaint)
+{
+    CustomPaintTabBar tabBar;
+    tabBar.addTab("tab");
+
+    // 重写了 paintTab 的子类不使用缓存，每次都重新绘制
+    const QPixmap pixmap = tabBar.createDragPixmapFromTab(0, tabOption(&tabBar, 0), nullptr);
+    ASSERT_NE(tabBar.createDragPixmapFromTab(0, tabOption(&tabBar, 0), nullptr).cacheKey(), pixmap.cacheKey());
+};
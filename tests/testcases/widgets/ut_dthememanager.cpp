@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "dthememanager.h"
+
+#if DTK_VERSION < DTK_VERSION_CHECK(6, 0, 0, 0)
+
+#include <QApplication>
+#include <QLabel>
+#include <QStyle>
+#include <QVBoxLayout>
+
+QT_WARNING_DISABLE_DEPRECATED
+
+DWIDGET_USE_NAMESPACE
+
+class ut_DThemeManager : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // 创建 DThemeManager 时会切换应用的样式，测试结束后恢复
+        styleName = qApp->style()->objectName();
+        manager = DThemeManager::instance();
+    }
+
+    void TearDown() override
+    {
+        if (qApp->style()->objectName() != styleName)
+            qApp->setStyle(styleName);
+    }
+
+    QString styleName;
+    DThemeManager *manager = nullptr;
+};
+
+TEST_F(ut_DThemeManager, repolishChildrenOnPropertyChange)
+{
+    ASSERT_TRUE(manager);
+
+    QWidget parent;
+    QLabel *label = new QLabel("label", &parent);
+    QVBoxLayout *layout = new QVBoxLayout(&parent);
+    layout->addWidget(label);
+
+    DThemeManager::registerWidget(&parent, QStringList { "state" });
+    parent.setStyleSheet(parent.styleSheet() + "QWidget[state=\"on\"] QLabel { color: #ff0000; }");
+    parent.ensurePolished();
+    ASSERT_NE(label->palette().color(QPalette::WindowText), QColor(Qt::red));
+
+    // 子控件只被依赖父控件属性的后代选择器匹配，属性变化后也要重新匹配
+    parent.setProperty("state", "on");
+    ASSERT_EQ(label->palette().color(QPalette::WindowText), QColor(Qt::red));
+
+    parent.setProperty("state", "off");
+    ASSERT_NE(label->palette().color(QPalette::WindowText), QColor(Qt::red));
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <QDebug>
 
 #include "DTitlebar"
+#include "DHorizontalLine"
 
 DWIDGET_USE_NAMESPACE
 
@@ -92,6 +93,19 @@ TEST_F(ut_DTitlebar, testDTitlebarsetSeparatorVisible)
     // TODO
 }
 
+TEST_F(ut_DTitlebar, testDTitlebarCoalescedResize)
+{
+    widget->show();
+    titleBar->resize(200, titleBar->height());
+    titleBar->resize(250, titleBar->height());
+    titleBar->resize(280, titleBar->height());
+    QCoreApplication::sendPostedEvents(titleBar, QEvent::LayoutRequest);
+
+    for (auto separator : titleBar->findChildren<DHorizontalLine *>(QString(), Qt::FindDirectChildrenOnly)) {
+        ASSERT_EQ(separator->width(), 280);
+    }
+}
+
 TEST_F(ut_DTitlebar, testDTitlebarSetTitle)
 {
     QString title("testDTitlebarSetTitle");
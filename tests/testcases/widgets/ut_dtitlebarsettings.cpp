@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include <DLineEdit>
 #include <QTest>
+#include <QTemporaryDir>
 
 #include "dtitlebar.h"
 #include "private/dtitlebarsettingsimpl.h"
@@ -81,6 +82,29 @@ TEST_F(ut_DTitlebarDataStore, addAndRemove)
     }
 }
 
+TEST_F(ut_DTitlebarDataStore, reloadOnExternalChange)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("titlebar-settings.json");
+
+    auto writeMeta = [&path](const QByteArray &data) {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(data);
+    };
+
+    writeMeta(R"({"spacingSize": 20, "tools": [{"key": "test-tool"}]})");
+    DTitlebarDataStore dataStore;
+    ASSERT_TRUE(dataStore.load(path));
+    ASSERT_EQ(dataStore.spacingSize(), 20);
+    ASSERT_EQ(dataStore.defaultIds(), QStringList({"test-tool", "builtin/stretch"}));
+
+    writeMeta(R"({"spacingSize": 30, "tools": [{"key": "test-tool2"}]})");
+    ASSERT_TRUE(QTest::qWaitFor([&dataStore] { return dataStore.spacingSize() == 30; }));
+    ASSERT_EQ(dataStore.defaultIds(), QStringList({"test-tool2", "builtin/stretch"}));
+}
+
 class TitleBarToolTest : public DTitleBarToolInterface {
 public:
     virtual QWidget *createView() override
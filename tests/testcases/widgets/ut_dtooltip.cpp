@@ -5,6 +5,11 @@
 #include <gtest/gtest.h>
 
 #include "dtooltip.h"
+
+#include <QApplication>
+#include <QHelpEvent>
+#include <QToolTip>
+
 DWIDGET_USE_NAMESPACE
 class ut_DToolTip : public testing::Test
 {
@@ -27,3 +32,34 @@ TEST_F(ut_DToolTip, sizeHint)
 {
     ASSERT_GE(target->sizeHint().width(), target->fontMetrics().size(Qt::TextSingleLine, target->text()).width());
 };
+
+TEST_F(ut_DToolTip, wrapToolTipText)
+{
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    const QString text = QString("DToolTip ").repeated(100);
+
+    const QString wrapped = DToolTip::wrapToolTipText(text, option);
+    ASSERT_TRUE(wrapped.contains('\n'));
+    ASSERT_EQ(QString(wrapped).remove('\n'), text);
+    ASSERT_EQ(DToolTip::wrapToolTipText(text, option), wrapped);
+
+    option.setWrapMode(QTextOption::NoWrap);
+    ASSERT_EQ(DToolTip::wrapToolTipText(text, option), text);
+};
+
+TEST_F(ut_DToolTip, setWrappedToolTip)
+{
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    const QString text = QString("DToolTip ").repeated(100);
+
+    QWidget widget;
+    DToolTip::setWrappedToolTip(&widget, text, option);
+    ASSERT_EQ(widget.toolTip(), text);
+
+    QHelpEvent event(QEvent::ToolTip, QPoint(), QPoint());
+    QApplication::sendEvent(&widget, &event);
+    QToolTip::hideText();
+    ASSERT_EQ(widget.toolTip(), DToolTip::wrapToolTipText(text, option));
+};